@@ -0,0 +1,118 @@
+/*
+ * SPICarrierPatternTest.cpp
+ *
+ *  Checks the carrier bit patterns, which are sent at the MOSI pin if SEND_PWM_BY_SPI is defined.
+ *  For all common carrier frequencies, the pattern must start with the on period, contain an integer number of periods
+ *  to be repeated without phase jump, have the exact mean frequency and the duty cycle of IR_SEND_DUTY_CYCLE_PERCENT.
+ *  The pattern generator does not access any hardware, so this test runs on every board.
+ *
+ *  It can also be compiled and run on the host with:
+ *  g++ -x c++ -I../../src SPICarrierPatternTest.ino -o SPICarrierPatternTest && ./SPICarrierPatternTest
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ *  MIT License
+ */
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <stdio.h>
+#endif
+
+#include "IRSPICarrierPattern.hpp"
+
+#define BIT_RATE                1000000 // The default of IR_SPI_BIT_RATE
+#define PATTERN_SIZE            125     // The default of IR_SPI_PATTERN_SIZE
+#define DUTY_CYCLE_PERCENT      30      // The default of IR_SEND_DUTY_CYCLE_PERCENT
+#define MAXIMUM_DUTY_CYCLE_DEVIATION_PERCENT 2
+
+const uint8_t FrequenciesKHz[] = { 30, 33, 36, 38, 40, 56 };
+
+uint8_t sPattern[PATTERN_SIZE];
+
+void printLine(const char *aLine) {
+#if defined(ARDUINO)
+    Serial.println(aLine);
+#else
+    puts(aLine);
+#endif
+}
+
+/*
+ * @return true if the pattern for aFrequencyKHz is OK
+ */
+bool checkPattern(uint8_t aFrequencyKHz) {
+    uint32_t tFrequencyHz = aFrequencyKHz * 1000UL;
+    uint16_t tNumberOfBytes = computeSPICarrierPattern(sPattern, PATTERN_SIZE, BIT_RATE, tFrequencyHz, DUTY_CYCLE_PERCENT);
+    uint32_t tNumberOfBits = (uint32_t) tNumberOfBytes * 8;
+
+    /*
+     * Count the on bits and the rising edges, including the one from the last to the first bit of the repeated pattern
+     */
+    uint32_t tNumberOfOnBits = 0;
+    uint32_t tNumberOfPeriods = 0;
+    bool tLastBit = sPattern[tNumberOfBytes - 1] & 0x01;
+    for (uint16_t i = 0; i < tNumberOfBytes; i++) {
+        for (uint8_t tMask = 0x80; tMask != 0; tMask >>= 1) {
+            bool tBit = sPattern[i] & tMask;
+            if (tBit) {
+                tNumberOfOnBits++;
+                if (!tLastBit) {
+                    tNumberOfPeriods++;
+                }
+            }
+            tLastBit = tBit;
+        }
+    }
+    uint8_t tDutyCyclePercent = (tNumberOfOnBits * 100 + (tNumberOfBits / 2)) / tNumberOfBits;
+
+    bool tIsOK = (sPattern[0] & 0x80) // starts with the on period
+            && (tNumberOfBits * tFrequencyHz) % BIT_RATE == 0 // integer number of periods
+            && tNumberOfPeriods == (tNumberOfBits * tFrequencyHz) / BIT_RATE // exact mean frequency
+            && tDutyCyclePercent >= DUTY_CYCLE_PERCENT - MAXIMUM_DUTY_CYCLE_DEVIATION_PERCENT
+            && tDutyCyclePercent <= DUTY_CYCLE_PERCENT + MAXIMUM_DUTY_CYCLE_DEVIATION_PERCENT;
+
+    char tLine[80];
+    snprintf(tLine, sizeof(tLine), "%2u kHz: %3u bytes, %3lu periods, %2u%% duty cycle %s", aFrequencyKHz, tNumberOfBytes,
+            (unsigned long) tNumberOfPeriods, tDutyCyclePercent, tIsOK ? "OK" : "FAILED");
+    printLine(tLine);
+    return tIsOK;
+}
+
+/*
+ * @return true if the patterns for all frequencies are OK
+ */
+bool checkAllPatterns() {
+    bool tAllAreOK = true;
+    for (uint8_t i = 0; i < sizeof(FrequenciesKHz); i++) {
+        if (!checkPattern(FrequenciesKHz[i])) {
+            tAllAreOK = false;
+        }
+    }
+    printLine(tAllAreOK ? "All patterns are OK" : "Pattern check FAILED");
+    return tAllAreOK;
+}
+
+#if defined(ARDUINO)
+void setup() {
+    Serial.begin(115200);
+
+#if defined(__AVR_ATmega32U4__) || defined(SERIAL_PORT_USBVIRTUAL) || defined(SERIAL_USB) /*stm32duino*/|| defined(USBCON) /*STM32_stm32*/|| defined(SERIALUSB_PID) || defined(ARDUINO_attiny3217)
+    delay(4000); // To be able to connect Serial monitor after reset or power up and before first print out. Do not wait for an attached Serial Monitor!
+#endif
+    // Just to know which program is running on my Arduino
+    Serial.println(F("START " __FILE__ " from " __DATE__));
+
+    checkAllPatterns();
+}
+
+void loop() {
+}
+#else
+int main() {
+    return checkAllPatterns() ? 0 : 1;
+}
+#endif
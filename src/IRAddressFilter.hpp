@@ -0,0 +1,156 @@
+/**
+ * @file IRAddressFilter.hpp
+ *
+ * @brief Early dropping of frames for other devices by an address allow-list.
+ * For NEC, Samsung and Kaseikyo frames the address bits are extracted directly from the raw buffer before any decoder is run.
+ * Frames with an address not in the list, and the repeats following them, are dropped and counted,
+ * and decode() returns false as if nothing was received.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_ADDRESS_FILTER_HPP
+#define _IR_ADDRESS_FILTER_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Receiving Receiving IR data for multiple protocols
+ * @{
+ */
+
+uint16_t const *sAllowedAddresses;
+uint8_t sNumberOfAllowedAddresses;
+bool sLastFrameWasFiltered; // To drop the repeats of a dropped frame too
+
+/**
+ * Sets the list of addresses of the frames, which are passed to the decoders.
+ * NEC, Samsung and Kaseikyo frames with other addresses are dropped. Frames of other protocols are not affected.
+ * @param aAllowedAddresses Array of addresses as they would appear in decodedIRData.address.
+ *                          For NEC, 8 bit addresses match both the 8 bit and the 16 bit form. The array is not copied!
+ *                          Apple frames are NEC frames with the fixed address APPLE_ADDRESS (0x87EE),
+ *                          add it to the array to receive them.
+ * @param aNumberOfAllowedAddresses 0 disables filtering.
+ */
+void IRrecv::setAddressFilter(const uint16_t *aAllowedAddresses, uint8_t aNumberOfAllowedAddresses) {
+    sAllowedAddresses = aAllowedAddresses;
+    sNumberOfAllowedAddresses = aNumberOfAllowedAddresses;
+    sLastFrameWasFiltered = false;
+    numberOfFilteredFrames = 0;
+}
+
+static bool isAllowedAddress(uint16_t aAddress) {
+    for (uint_fast8_t i = 0; i < sNumberOfAllowedAddresses; i++) {
+        if (sAllowedAddresses[i] == aAddress) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Decodes LSB first pulse distance bits. Only the spaces are evaluated, the full check is done later by the decoder.
+ * @param aStartBitIndex    Index of the first bit to decode, 0 is the first bit after the header.
+ */
+static uint16_t getPulseDistanceBitsLSBFirst(IRData *aIRData, uint_fast8_t aStartBitIndex, uint_fast8_t aNumberOfBits,
+        uint16_t aThresholdMicros) {
+    auto *tRawBufPointer = &aIRData->rawDataPtr->rawbuf[4 + (2 * aStartBitIndex)]; // skip gap and header, then point to first space
+    uint16_t tThresholdTicks = (aThresholdMicros + MARK_EXCESS_MICROS) / MICROS_PER_TICK;
+    uint16_t tValue = 0;
+    for (uint_fast8_t i = 0; i < aNumberOfBits; i++) {
+        if (*tRawBufPointer > tThresholdTicks) {
+            tValue |= 1 << i;
+        }
+        tRawBufPointer += 2;
+    }
+    return tValue;
+}
+
+/**
+ * Checks the address of NEC, Samsung and Kaseikyo frames against the allow-list set by setAddressFilter().
+ * Repeat frames are filtered, if the frame before was filtered. They are counted as filtered frames too.
+ * @return true if frame is to be dropped.
+ */
+bool IRrecv::isFilteredByAddress() {
+    if (sNumberOfAllowedAddresses == 0) {
+        return false;
+    }
+    auto tRawlen = decodedIRData.rawDataPtr->rawlen;
+    auto *tRawBufPointer = decodedIRData.rawDataPtr->rawbuf;
+    bool tIsAllowed;
+
+    if (matchMark(tRawBufPointer[1], NEC_HEADER_MARK)) {
+        if (tRawlen == 4) {
+            tIsAllowed = !sLastFrameWasFiltered; // NEC repeat
+        } else if (tRawlen != (2 * NEC_BITS) + 4) {
+            return false;
+        } else {
+            uint16_t tAddress = getPulseDistanceBitsLSBFirst(&decodedIRData, 0, 16, (NEC_ONE_SPACE + NEC_ZERO_SPACE) / 2);
+            tIsAllowed = isAllowedAddress(tAddress)
+                    || ((tAddress >> 8) == (~tAddress & 0xFF) && isAllowedAddress(tAddress & 0xFF));
+        }
+
+    } else if (matchMark(tRawBufPointer[1], SAMSUNG_HEADER_MARK) && matchSpace(tRawBufPointer[2], SAMSUNG_HEADER_SPACE)) {
+        if (tRawlen == 6) {
+            tIsAllowed = !sLastFrameWasFiltered; // Samsung repeat
+        } else if (tRawlen != (2 * SAMSUNG_BITS) + 4 && tRawlen != (2 * SAMSUNG48_BITS) + 4) {
+            return false;
+        } else {
+            tIsAllowed = isAllowedAddress(
+                    getPulseDistanceBitsLSBFirst(&decodedIRData, 0, 16, (SAMSUNG_ONE_SPACE + SAMSUNG_ZERO_SPACE) / 2));
+        }
+
+    } else if (matchMark(tRawBufPointer[1], KASEIKYO_HEADER_MARK) && matchSpace(tRawBufPointer[2], KASEIKYO_HEADER_SPACE)) {
+        if (tRawlen != (2 * KASEIKYO_BITS) + 4) {
+            return false;
+        }
+        // The 12 address bits follow the 16 bit vendor ID and the 4 bit vendor parity
+        tIsAllowed = isAllowedAddress(
+                getPulseDistanceBitsLSBFirst(&decodedIRData, KASEIKYO_VENDOR_ID_BITS + KASEIKYO_VENDOR_ID_PARITY_BITS,
+                        KASEIKYO_ADDRESS_BITS, (KASEIKYO_ONE_SPACE + KASEIKYO_ZERO_SPACE) / 2));
+
+    } else {
+        return false;
+    }
+
+    sLastFrameWasFiltered = !tIsAllowed;
+    if (!tIsAllowed) {
+        numberOfFilteredFrames++;
+#if defined(LOCAL_DEBUG)
+        Serial.println(F("Frame dropped by address filter"));
+#endif
+    }
+    return !tIsAllowed;
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_ADDRESS_FILTER_HPP
@@ -0,0 +1,200 @@
+/**
+ * @file IRBridge.hpp
+ *
+ * @brief Table driven translation of received IR codes to other IR codes, e.g. for universal remote hubs.
+ * The mapping table in FLASH maps protocol, address and command of a received frame to a protocol frame or compressed raw data to send.
+ * A hash index in RAM gives constant lookup time independent of the table size.
+ * Output is queued and sent by serviceBridge() only if no frame is currently received, so the receiver need not be stopped.
+ * Received repeats are sent as the native repeat frame of the output protocol.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_BRIDGE_HPP
+#define _IR_BRIDGE_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Sending Sending IR data for multiple protocols
+ * @{
+ */
+/*
+ * Example:
+ * const IRBridgeEntry BridgeTable[] PROGMEM = {
+ *      { NEC, 0x04, 0x08, SAMSUNG, 0x0707, 0x02, NULL }, // NEC power -> Samsung TV power
+ *      { NEC, 0x04, 0x09, UNKNOWN, 0, 0, PowerButtonCompressedRaw } }; // NEC 0x09 -> compressed raw data of a learned code
+ * setBridgeTable_P(BridgeTable, sizeof(BridgeTable) / sizeof(IRBridgeEntry));
+ * loop():
+ *      if (IrReceiver.decode()) {
+ *          queueBridgeOutput(&IrReceiver.decodedIRData);
+ *          IrReceiver.resume();
+ *      }
+ *      serviceBridge();
+ */
+
+IRBridgeEntry const *sBridgeTablePGM;
+uint8_t sBridgeHashTable[IR_BRIDGE_HASH_TABLE_SIZE]; // Index + 1 of the entry in sBridgeTablePGM, 0 is empty
+
+struct IRBridgeQueueEntry {
+    uint8_t EntryIndex;
+    bool IsRepeat;
+};
+IRBridgeQueueEntry sBridgeQueue[IR_BRIDGE_QUEUE_SIZE];
+volatile uint8_t sBridgeQueueReadIndex;
+volatile uint8_t sBridgeQueueWriteIndex;
+
+static uint_fast8_t getBridgeHash(decode_type_t aProtocol, uint16_t aAddress, uint16_t aCommand) {
+    uint16_t tHash = (aProtocol * 0x3D) ^ (aAddress * 0x1F) ^ aCommand;
+    return (tHash ^ (tHash >> 8)) & (IR_BRIDGE_HASH_TABLE_SIZE - 1);
+}
+
+/**
+ * Sets the mapping table and builds the hash index.
+ * @param aBridgeTablePGM   Array of entries in FLASH (declared with PROGMEM).
+ * @return false if the table has more than IR_BRIDGE_HASH_TABLE_SIZE - 1 entries or contains an input twice.
+ */
+bool setBridgeTable_P(IRBridgeEntry const *aBridgeTablePGM, uint8_t aNumberOfEntries) {
+    sBridgeTablePGM = aBridgeTablePGM;
+    memset(sBridgeHashTable, 0, sizeof(sBridgeHashTable));
+    sBridgeQueueReadIndex = sBridgeQueueWriteIndex;
+    if (aNumberOfEntries >= IR_BRIDGE_HASH_TABLE_SIZE) {
+        return false;
+    }
+    bool tReturnValue = true;
+    for (uint_fast8_t i = 0; i < aNumberOfEntries; i++) {
+        IRBridgeEntry tEntry;
+        memcpy_P(&tEntry, &aBridgeTablePGM[i], sizeof(tEntry));
+        if (findBridgeEntry(tEntry.InputProtocol, tEntry.InputAddress, tEntry.InputCommand) >= 0) {
+            tReturnValue = false; // duplicate input, first entry wins
+            continue;
+        }
+        // open addressing with linear probing
+        uint_fast8_t tHashIndex = getBridgeHash(tEntry.InputProtocol, tEntry.InputAddress, tEntry.InputCommand);
+        while (sBridgeHashTable[tHashIndex] != 0) {
+            tHashIndex = (tHashIndex + 1) & (IR_BRIDGE_HASH_TABLE_SIZE - 1);
+        }
+        sBridgeHashTable[tHashIndex] = i + 1;
+    }
+    return tReturnValue;
+}
+
+/**
+ * @return Index of the entry for the input or -1 if not found.
+ */
+int_fast16_t findBridgeEntry(decode_type_t aProtocol, uint16_t aAddress, uint16_t aCommand) {
+    uint_fast8_t tHashIndex = getBridgeHash(aProtocol, aAddress, aCommand);
+    uint8_t tEntryIndexPlusOne;
+    while ((tEntryIndexPlusOne = sBridgeHashTable[tHashIndex]) != 0) {
+        IRBridgeEntry const *tEntryPGM = &sBridgeTablePGM[tEntryIndexPlusOne - 1];
+        /*
+         * Compare the input only, without copying the whole entry
+         */
+        decode_type_t tProtocol;
+        uint16_t tAddress, tCommand;
+        memcpy_P(&tProtocol, &tEntryPGM->InputProtocol, sizeof(tProtocol));
+        memcpy_P(&tAddress, &tEntryPGM->InputAddress, sizeof(tAddress));
+        memcpy_P(&tCommand, &tEntryPGM->InputCommand, sizeof(tCommand));
+        if (tProtocol == aProtocol && tAddress == aAddress && tCommand == aCommand) {
+            return tEntryIndexPlusOne - 1;
+        }
+        tHashIndex = (tHashIndex + 1) & (IR_BRIDGE_HASH_TABLE_SIZE - 1);
+    }
+    return -1;
+}
+
+/**
+ * Looks up the decoded data in the mapping table and queues the output for serviceBridge().
+ * @return false if input is not in table or queue is full.
+ */
+bool queueBridgeOutput(IRData *aIRReceivedData) {
+    if (aIRReceivedData->flags & (IRDATA_FLAGS_WAS_OVERFLOW | IRDATA_FLAGS_PARITY_FAILED)) {
+        return false;
+    }
+    int_fast16_t tEntryIndex = findBridgeEntry(aIRReceivedData->protocol, aIRReceivedData->address, aIRReceivedData->command);
+    if (tEntryIndex < 0) {
+        return false;
+    }
+    uint8_t tWriteIndex = sBridgeQueueWriteIndex;
+    uint8_t tNextWriteIndex = (tWriteIndex + 1) % IR_BRIDGE_QUEUE_SIZE;
+    if (tNextWriteIndex == sBridgeQueueReadIndex) {
+#if defined(LOCAL_DEBUG)
+        Serial.println(F("Bridge queue is full"));
+#endif
+        return false;
+    }
+    sBridgeQueue[tWriteIndex].EntryIndex = tEntryIndex;
+    sBridgeQueue[tWriteIndex].IsRepeat = (aIRReceivedData->flags & IRDATA_FLAGS_IS_REPEAT);
+    sBridgeQueueWriteIndex = tNextWriteIndex;
+    return true;
+}
+
+/*
+ * Only these protocols send a special repeat frame for a negative number of repeats.
+ * All others send nothing or a plain frame, depending on the protocol.
+ */
+static bool hasSpecialRepeatFrame(decode_type_t aProtocol) {
+    return (aProtocol == NEC || aProtocol == ONKYO || aProtocol == APPLE || aProtocol == LG || aProtocol == SAMSUNG
+            || aProtocol == SAMSUNG_LG || aProtocol == JVC);
+}
+
+/**
+ * Sends the next queued output, if the receiver is not just receiving a frame.
+ * Call it in every loop.
+ * @return true if an output was sent.
+ */
+bool serviceBridge() {
+    uint8_t tReadIndex = sBridgeQueueReadIndex;
+    if (tReadIndex == sBridgeQueueWriteIndex || !IrReceiver.isIdle()) {
+        return false;
+    }
+    IRBridgeEntry tEntry;
+    memcpy_P(&tEntry, &sBridgeTablePGM[sBridgeQueue[tReadIndex].EntryIndex], sizeof(tEntry));
+    if (tEntry.OutputProtocol == UNKNOWN) {
+        if (tEntry.OutputCompressedRawPGM != NULL) {
+            IrSender.sendRawCompressed_P(tEntry.OutputCompressedRawPGM, IR_BRIDGE_RAW_FREQUENCY_KHZ);
+        }
+    } else {
+        // Send the special repeat frame of the protocol for a repeat, and a plain frame without repeats otherwise
+        int_fast8_t tNumberOfRepeats = 0;
+        if (sBridgeQueue[tReadIndex].IsRepeat && hasSpecialRepeatFrame(tEntry.OutputProtocol)) {
+            tNumberOfRepeats = -1;
+        }
+        IrSender.write(tEntry.OutputProtocol, tEntry.OutputAddress, tEntry.OutputCommand, tNumberOfRepeats);
+    }
+    sBridgeQueueReadIndex = (tReadIndex + 1) % IR_BRIDGE_QUEUE_SIZE;
+    IrReceiver.restartAfterSend();
+    return true;
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_BRIDGE_HPP
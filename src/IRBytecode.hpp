@@ -0,0 +1,418 @@
+/**
+ * @file IRBytecode.hpp
+ *
+ * @brief Small interpreter for sending protocols described by bytecode.
+ * The bytecode can be located in RAM, FLASH or EEPROM, so new remotes can be supported without reflashing,
+ * and a protocol description requires only around 20 to 40 bytes.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_BYTECODE_HPP
+#define _IR_BYTECODE_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Sending Sending IR data for multiple protocols
+ * @{
+ */
+
+/*
+ * The interpreter has 8 registers of 16 bit.
+ * At start, R0 contains the address, R1 the command and R2 the toggle bit, which changes at each call of sendBytecode().
+ * All 16 bit operands are stored low byte first, use the IR_BYTECODE_16() macro.
+ *
+ * Example for NEC {38k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,^108m,(16,-4,1,^108m)*)
+ * const uint8_t NECBytecode[] PROGMEM = { IR_BC_FREQUENCY, 38,
+ *      IR_BC_BIT_TIMING, IR_BYTECODE_16(560), IR_BYTECODE_16(1690), IR_BYTECODE_16(560), IR_BYTECODE_16(560),
+ *      IR_BC_MARK, IR_BYTECODE_16(9000), IR_BC_SPACE, IR_BYTECODE_16(4500),
+ *      IR_BC_BITS, 0, 16, IR_BC_MOVE, 3, 1, IR_BC_NOT, 3, IR_BC_SHIFT_LEFT, 3, 8, IR_BC_OR, 3, 1, IR_BC_BITS, 3, 16,
+ *      IR_BC_MARK, IR_BYTECODE_16(560),
+ *      IR_BC_REPEAT, IR_BYTECODE_16(110), IR_BYTECODE_16(42), // 42 is the offset of the next instruction
+ *      IR_BC_MARK, IR_BYTECODE_16(9000), IR_BC_SPACE, IR_BYTECODE_16(2250), IR_BC_MARK, IR_BYTECODE_16(560),
+ *      IR_BC_REPEAT, IR_BYTECODE_16(110), IR_BYTECODE_16(42), IR_BC_END };
+ * IrSender.sendBytecode_P(NECBytecode, sizeof(NECBytecode), 0x04, 0x08, 2);
+ */
+#define IR_BYTECODE_16(aValue)  ((aValue) & 0xFF), (((aValue) >> 8) & 0xFF)
+
+#define IR_BC_END           0x00 ///< End of program
+#define IR_BC_FREQUENCY     0x01 ///< <kHz> Set carrier frequency
+#define IR_BC_MARK          0x02 ///< <micros16> Send mark
+#define IR_BC_SPACE         0x03 ///< <micros16> Send space
+#define IR_BC_BIT_TIMING    0x04 ///< <one mark16><one space16><zero mark16><zero space16> Set timing for IR_BC_BITS
+#define IR_BC_BITS          0x05 ///< <register><number of bits (1 to 16) | IR_BC_MSB_FIRST> Send pulse distance width bits of register, no stop bit
+#define IR_BC_BIPHASE_BITS  0x06 ///< <time unit16><register><number of bits (1 to 16)> Send biphase bits of register MSB first, like sendBiphaseData()
+#define IR_BC_LOOP          0x07 ///< <count> Execute the code up to IR_BC_END_LOOP count times. Loops can not be nested.
+#define IR_BC_END_LOOP      0x08
+#define IR_BC_REPEAT        0x09 ///< <period millis16><offset16> If repeats are left, wait for end of period and continue at offset of repeat frame. Offset must be the start of an instruction.
+#define IR_BC_LOAD          0x10 ///< <register><value16>
+#define IR_BC_MOVE          0x11 ///< <destination register><source register>
+#define IR_BC_ADD           0x12 ///< <destination register><source register>
+#define IR_BC_XOR           0x13 ///< <destination register><source register>
+#define IR_BC_OR            0x14 ///< <destination register><source register>
+#define IR_BC_AND           0x15 ///< <register><value16>
+#define IR_BC_NOT           0x16 ///< <register>
+#define IR_BC_SHIFT_LEFT    0x17 ///< <register><number of bits>
+#define IR_BC_SHIFT_RIGHT   0x18 ///< <register><number of bits>
+#define IR_BC_ADD_BYTES     0x19 ///< <register> Register = low byte + high byte, for checksums
+#define IR_BC_XOR_NIBBLES   0x1A ///< <register> Register = XOR of all 4 nibbles, for checksums
+
+#define IR_BC_MSB_FIRST     0x80
+#define IR_BC_NUMBER_OF_REGISTERS   8
+
+uint8_t sBytecodeToggleBit;
+
+/*
+ * @return Number of bytes of the instruction including its operands, or 0 for an unknown opcode
+ */
+static uint8_t getBytecodeInstructionLength(uint8_t aOpcode) {
+    switch (aOpcode) {
+    case IR_BC_END:
+    case IR_BC_END_LOOP:
+        return 1;
+    case IR_BC_FREQUENCY:
+    case IR_BC_LOOP:
+    case IR_BC_NOT:
+    case IR_BC_ADD_BYTES:
+    case IR_BC_XOR_NIBBLES:
+        return 2;
+    case IR_BC_MARK:
+    case IR_BC_SPACE:
+    case IR_BC_BITS:
+    case IR_BC_MOVE:
+    case IR_BC_ADD:
+    case IR_BC_XOR:
+    case IR_BC_OR:
+    case IR_BC_SHIFT_LEFT:
+    case IR_BC_SHIFT_RIGHT:
+        return 3;
+    case IR_BC_LOAD:
+    case IR_BC_AND:
+        return 4;
+    case IR_BC_BIPHASE_BITS:
+    case IR_BC_REPEAT:
+        return 5;
+    case IR_BC_BIT_TIMING:
+        return 9;
+    default:
+        return 0;
+    }
+}
+
+/*
+ * @return true if aOffset is the start of an instruction
+ */
+static bool isBytecodeInstructionStart(const uint8_t *aBytecode, uint16_t aBytecodeLength,
+        uint8_t (*aReadByteFunction)(const uint8_t *aBytePtr), uint16_t aOffset) {
+    if (aOffset >= aBytecodeLength) {
+        return false;
+    }
+    uint16_t tOffset = 0;
+    while (tOffset < aOffset) {
+        uint8_t tLength = getBytecodeInstructionLength(aReadByteFunction(aBytecode + tOffset));
+        if (tLength == 0) {
+            return false;
+        }
+        tOffset += tLength;
+    }
+    return (tOffset == aOffset);
+}
+
+/**
+ * Checks the bytecode before it is executed, so a wrong program can not run off the end of the array.
+ * Each instruction must be complete, bit counts must be 1 to 16, since the registers have 16 bit,
+ * each repeat offset must be the start of an instruction and each IR_BC_LOOP must be closed by an IR_BC_END_LOOP without nesting.
+ * Is called by sendBytecode().
+ * @return false if bytecode is invalid.
+ */
+bool checkBytecode(const uint8_t *aBytecode, uint16_t aBytecodeLength, uint8_t (*aReadByteFunction)(const uint8_t *aBytePtr)) {
+    uint16_t tOffset = 0;
+    bool tLoopIsOpen = false;
+    while (tOffset < aBytecodeLength) {
+        uint8_t tOpcode = aReadByteFunction(aBytecode + tOffset);
+        uint8_t tLength = getBytecodeInstructionLength(tOpcode);
+        if (tLength == 0 || tOffset + tLength > aBytecodeLength) {
+#if defined(LOCAL_DEBUG)
+            Serial.print(F("Unknown or incomplete opcode at "));
+            Serial.println(tOffset);
+#endif
+            return false;
+        }
+        if (tOpcode == IR_BC_LOOP || tOpcode == IR_BC_END_LOOP) {
+            // The interpreter has only one loop start and count, so a loop must be closed before the next one is opened
+            if ((tOpcode == IR_BC_LOOP) == tLoopIsOpen) {
+#if defined(LOCAL_DEBUG)
+                Serial.print(F("Nested or unbalanced loop at "));
+                Serial.println(tOffset);
+#endif
+                return false;
+            }
+            tLoopIsOpen = (tOpcode == IR_BC_LOOP);
+        }
+        const uint8_t *tOperandPtr = aBytecode + tOffset + 1;
+        uint8_t tNumberOfBits = 1;
+        if (tOpcode == IR_BC_BITS) {
+            tNumberOfBits = aReadByteFunction(tOperandPtr + 1) & ~IR_BC_MSB_FIRST;
+        } else if (tOpcode == IR_BC_BIPHASE_BITS) {
+            tNumberOfBits = aReadByteFunction(tOperandPtr + 3);
+        } else if (tOpcode == IR_BC_REPEAT) {
+            uint16_t tRepeatOffset = aReadByteFunction(tOperandPtr + 2) | (aReadByteFunction(tOperandPtr + 3) << 8);
+            if (!isBytecodeInstructionStart(aBytecode, aBytecodeLength, aReadByteFunction, tRepeatOffset)) {
+#if defined(LOCAL_DEBUG)
+                Serial.print(F("Invalid repeat offset at "));
+                Serial.println(tOffset);
+#endif
+                return false;
+            }
+        }
+        if (tNumberOfBits == 0 || tNumberOfBits > 16) {
+#if defined(LOCAL_DEBUG)
+            Serial.print(F("Invalid number of bits at "));
+            Serial.println(tOffset);
+#endif
+            return false;
+        }
+        tOffset += tLength;
+    }
+#if defined(LOCAL_DEBUG)
+    if (tLoopIsOpen) {
+        Serial.println(F("Loop without end"));
+    }
+#endif
+    return !tLoopIsOpen;
+}
+
+static uint8_t readIRByteFromRAM(const uint8_t *aBytePtr) {
+    return *aBytePtr;
+}
+
+static uint8_t readIRByteFromFlash(const uint8_t *aBytePtr) {
+#if defined(__AVR__)
+    return pgm_read_byte(aBytePtr);
+#else
+    return *aBytePtr;
+#endif
+}
+
+/**
+ * Executes the bytecode in RAM.
+ * @return false if bytecode is invalid, then nothing is sent.
+ */
+bool IRsend::sendBytecode(const uint8_t *aBytecode, uint16_t aBytecodeLength, uint16_t aAddress, uint16_t aCommand,
+        int_fast8_t aNumberOfRepeats) {
+    return sendBytecode(aBytecode, aBytecodeLength, &readIRByteFromRAM, aAddress, aCommand, aNumberOfRepeats);
+}
+
+/**
+ * Executes the bytecode in FLASH (declared with PROGMEM).
+ * @return false if bytecode is invalid, then nothing is sent.
+ */
+bool IRsend::sendBytecode_P(const uint8_t *aBytecodePGM, uint16_t aBytecodeLength, uint16_t aAddress, uint16_t aCommand,
+        int_fast8_t aNumberOfRepeats) {
+    return sendBytecode(aBytecodePGM, aBytecodeLength, &readIRByteFromFlash, aAddress, aCommand, aNumberOfRepeats);
+}
+
+/**
+ * Executes the bytecode, which is read with aReadByteFunction.
+ * E.g. for EEPROM use: uint8_t readEEPROM(const uint8_t *aBytePtr) { return EEPROM.read((int) aBytePtr); }
+ * and sendBytecode((const uint8_t *) EEPROMStartOffset, &readEEPROM, ...)
+ *
+ * @param aBytecode         Start of the bytecode, which is passed with the offset of the current byte to aReadByteFunction.
+ * @param aBytecodeLength   Number of bytes of the bytecode. The program ends at IR_BC_END or at the end of the bytecode.
+ * @param aReadByteFunction Function to read one byte of bytecode.
+ * @param aNumberOfRepeats  Number of times IR_BC_REPEAT continues with the repeat frame.
+ * @return false if bytecode is invalid (see checkBytecode()), then nothing is sent.
+ */
+bool IRsend::sendBytecode(const uint8_t *aBytecode, uint16_t aBytecodeLength, uint8_t (*aReadByteFunction)(const uint8_t *aBytePtr),
+        uint16_t aAddress, uint16_t aCommand, int_fast8_t aNumberOfRepeats) {
+    if (!checkBytecode(aBytecode, aBytecodeLength, aReadByteFunction)) {
+        return false;
+    }
+    uint16_t tRegisters[IR_BC_NUMBER_OF_REGISTERS];
+    tRegisters[0] = aAddress;
+    tRegisters[1] = aCommand;
+    tRegisters[2] = sBytecodeToggleBit;
+    sBytecodeToggleBit ^= 1;
+
+    uint16_t tOneMarkMicros = 0;
+    uint16_t tOneSpaceMicros = 0;
+    uint16_t tZeroMarkMicros = 0;
+    uint16_t tZeroSpaceMicros = 0;
+
+    const uint8_t *tLoopStartPtr = aBytecode;
+    uint8_t tLoopCount = 0;
+    unsigned long tStartOfFrameMillis = millis();
+
+    const uint8_t *tBytePtr = aBytecode;
+    const uint8_t *tEndPtr = aBytecode + aBytecodeLength;
+    while (true) {
+        // checkBytecode() guarantees, that each instruction is complete and that we are at an instruction start here
+        uint8_t tOpcode = (tBytePtr < tEndPtr) ? aReadByteFunction(tBytePtr++) : IR_BC_END;
+        uint16_t tValue;
+        uint8_t tRegister = 0;
+        uint8_t tSourceRegister;
+        // Most opcodes have a register as first operand
+        if (tOpcode >= IR_BC_LOAD || tOpcode == IR_BC_BITS) {
+            tRegister = aReadByteFunction(tBytePtr++) & (IR_BC_NUMBER_OF_REGISTERS - 1);
+        }
+
+        switch (tOpcode) {
+        case IR_BC_FREQUENCY:
+            enableIROut(aReadByteFunction(tBytePtr++));
+            tStartOfFrameMillis = millis();
+            break;
+
+        case IR_BC_MARK:
+            tValue = aReadByteFunction(tBytePtr) | (aReadByteFunction(tBytePtr + 1) << 8);
+            tBytePtr += 2;
+            mark(tValue);
+            break;
+
+        case IR_BC_SPACE:
+            tValue = aReadByteFunction(tBytePtr) | (aReadByteFunction(tBytePtr + 1) << 8);
+            tBytePtr += 2;
+            space(tValue);
+            break;
+
+        case IR_BC_BIT_TIMING:
+            tOneMarkMicros = aReadByteFunction(tBytePtr) | (aReadByteFunction(tBytePtr + 1) << 8);
+            tOneSpaceMicros = aReadByteFunction(tBytePtr + 2) | (aReadByteFunction(tBytePtr + 3) << 8);
+            tZeroMarkMicros = aReadByteFunction(tBytePtr + 4) | (aReadByteFunction(tBytePtr + 5) << 8);
+            tZeroSpaceMicros = aReadByteFunction(tBytePtr + 6) | (aReadByteFunction(tBytePtr + 7) << 8);
+            tBytePtr += 8;
+            break;
+
+        case IR_BC_BITS:
+            tValue = aReadByteFunction(tBytePtr++); // number of bits and MSB flag
+            sendPulseDistanceWidthData(tOneMarkMicros, tOneSpaceMicros, tZeroMarkMicros, tZeroSpaceMicros, tRegisters[tRegister],
+                    tValue & ~IR_BC_MSB_FIRST,
+                    ((tValue & IR_BC_MSB_FIRST) ? PROTOCOL_IS_MSB_FIRST : PROTOCOL_IS_LSB_FIRST) | SUPPRESS_STOP_BIT_FOR_THIS_DATA);
+            break;
+
+        case IR_BC_BIPHASE_BITS:
+            tValue = aReadByteFunction(tBytePtr) | (aReadByteFunction(tBytePtr + 1) << 8);
+            tRegister = aReadByteFunction(tBytePtr + 2) & (IR_BC_NUMBER_OF_REGISTERS - 1);
+            sendBiphaseData(tValue, tRegisters[tRegister], aReadByteFunction(tBytePtr + 3));
+            tBytePtr += 4;
+            break;
+
+        case IR_BC_LOOP:
+            tLoopCount = aReadByteFunction(tBytePtr++);
+            tLoopStartPtr = tBytePtr;
+            break;
+
+        case IR_BC_END_LOOP:
+            if (tLoopCount > 1) {
+                tLoopCount--;
+                tBytePtr = tLoopStartPtr;
+            }
+            break;
+
+        case IR_BC_REPEAT:
+            if (aNumberOfRepeats <= 0) {
+                IRLedOff();  // Always end with the LED off
+                return true;
+            }
+            aNumberOfRepeats--;
+            tValue = aReadByteFunction(tBytePtr) | (aReadByteFunction(tBytePtr + 1) << 8); // period
+            {
+                /*
+                 * Check and fallback for wrong period parameter. I.e the repeat period must be greater than each frame duration.
+                 */
+                auto tFrameDurationMillis = millis() - tStartOfFrameMillis;
+                if (tValue > tFrameDurationMillis) {
+                    delay(tValue - tFrameDurationMillis);
+                }
+            }
+            tStartOfFrameMillis = millis();
+            tBytePtr = aBytecode + (aReadByteFunction(tBytePtr + 2) | (aReadByteFunction(tBytePtr + 3) << 8));
+            break;
+
+        case IR_BC_LOAD:
+            tRegisters[tRegister] = aReadByteFunction(tBytePtr) | (aReadByteFunction(tBytePtr + 1) << 8);
+            tBytePtr += 2;
+            break;
+
+        case IR_BC_MOVE:
+        case IR_BC_ADD:
+        case IR_BC_XOR:
+        case IR_BC_OR:
+            tSourceRegister = aReadByteFunction(tBytePtr++) & (IR_BC_NUMBER_OF_REGISTERS - 1);
+            if (tOpcode == IR_BC_MOVE) {
+                tRegisters[tRegister] = tRegisters[tSourceRegister];
+            } else if (tOpcode == IR_BC_ADD) {
+                tRegisters[tRegister] += tRegisters[tSourceRegister];
+            } else if (tOpcode == IR_BC_XOR) {
+                tRegisters[tRegister] ^= tRegisters[tSourceRegister];
+            } else {
+                tRegisters[tRegister] |= tRegisters[tSourceRegister];
+            }
+            break;
+
+        case IR_BC_AND:
+            tRegisters[tRegister] &= aReadByteFunction(tBytePtr) | (aReadByteFunction(tBytePtr + 1) << 8);
+            tBytePtr += 2;
+            break;
+
+        case IR_BC_NOT:
+            tRegisters[tRegister] = ~tRegisters[tRegister];
+            break;
+
+        case IR_BC_SHIFT_LEFT:
+            tRegisters[tRegister] <<= aReadByteFunction(tBytePtr++);
+            break;
+
+        case IR_BC_SHIFT_RIGHT:
+            tRegisters[tRegister] >>= aReadByteFunction(tBytePtr++);
+            break;
+
+        case IR_BC_ADD_BYTES:
+            tRegisters[tRegister] = (uint8_t) ((tRegisters[tRegister] & 0xFF) + (tRegisters[tRegister] >> 8));
+            break;
+
+        case IR_BC_XOR_NIBBLES:
+            tValue = tRegisters[tRegister];
+            tValue ^= tValue >> 8;
+            tRegisters[tRegister] = (tValue ^ (tValue >> 4)) & 0x0F;
+            break;
+
+        default: // Unknown opcodes are rejected by checkBytecode()
+        case IR_BC_END:
+            IRLedOff();  // Always end with the LED off
+            return true;
+        }
+    }
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_BYTECODE_HPP
@@ -0,0 +1,244 @@
+/**
+ * @file IRCarrierMeasurement.hpp
+ *
+ * @brief Receiving with a non demodulating IR receiver module like the TSMP58000, QSE159 or a plain IR photo diode circuit.
+ * Each carrier pulse of a mark generates an edge interrupt, which is used to measure carrier period and duty cycle.
+ * The envelope of the marks and spaces is stored in irparams.rawbuf, so all decoders and print functions can be used as usual.
+ *
+ * This is intended for learning of IR codes, where the exact carrier frequency is required for sending them again.
+ * Interrupt load is high during reception (2 interrupts per carrier period), so this is not suitable for normal receiving.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_CARRIER_MEASUREMENT_HPP
+#define _IR_CARRIER_MEASUREMENT_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Receiving Receiving IR data for multiple protocols
+ * @{
+ */
+
+/**
+ * Control and measurement data for the non demodulating receiver. Written only by the edge ISR, while not in IR_REC_STATE_STOP.
+ */
+struct IRCarrierMeasurementStruct {
+    uint32_t LastPulseStartMicros;  ///< micros() of the last active edge, used for gap and period measurement
+    uint32_t LastPulseEndMicros;    ///< micros() of the last inactive edge, i.e. the end of the current mark
+    uint32_t MarkStartMicros;       ///< micros() of the first carrier pulse of the current mark
+    uint32_t PeriodSumMicros;       ///< Sum of all valid carrier periods of the current frame
+    uint16_t PeriodCount;
+    uint32_t OnTimeSumMicros;       ///< Sum of all carrier pulse durations of the current frame
+    uint16_t OnTimeCount;
+};
+volatile IRCarrierMeasurementStruct sIRCarrierMeasurement;
+
+/*
+ * Stores one duration in rawbuf and clips it to 16 bit ticks
+ */
+#if defined(ESP8266) || defined(ESP32)
+IRAM_ATTR
+#endif
+static void storeCarrierEnvelopeDuration(uint32_t aDurationMicros) {
+    uint32_t tTicks = (aDurationMicros + (MICROS_PER_TICK / 2)) / MICROS_PER_TICK;
+    irparams.rawbuf[irparams.rawlen++] = (tTicks > UINT16_MAX) ? UINT16_MAX : tTicks;
+}
+
+/**
+ * Interrupt handler for each edge at the output of a non demodulating receiver.
+ * Replaces IRReceiveTimerInterruptHandler() if USE_NON_DEMODULATING_RECEIVER is defined.
+ * A carrier pulse start, which is more than IR_CARRIER_SPACE_THRESHOLD_MICROS after the last one, terminates the current mark.
+ * The end of a frame, i.e. a space longer than RECORD_GAP_MICROS, is detected by checkForEndOfCarrierFrame(), since no edge occurs then.
+ */
+#if defined(ESP8266) || defined(ESP32)
+IRAM_ATTR
+#endif
+void IRCarrierEdgeInterruptHandler() {
+    uint32_t tMicros = micros();
+#if defined(__AVR__)
+    uint8_t tIRInputLevel = *irparams.IRReceivePinPortInputRegister & irparams.IRReceivePinMask;
+    if (tIRInputLevel) {
+        tIRInputLevel = 1; // INPUT_MARK is 0 or 1
+    }
+#else
+    uint_fast8_t tIRInputLevel = (uint_fast8_t) digitalReadFast(irparams.IRReceivePin);
+#endif
+
+    if (tIRInputLevel == INPUT_MARK) {
+        /*
+         * Start of a carrier pulse
+         */
+        uint32_t tDeltaMicros = tMicros - sIRCarrierMeasurement.LastPulseStartMicros;
+        if (IR_LOAD_ACQUIRE(irparams.StateForISR) == IR_REC_STATE_IDLE) { // acquire the raw buffer released by resume()
+            // check if we did not start in the middle of a transmission by checking the minimum length of leading space
+            if (tDeltaMicros > RECORD_GAP_MICROS) {
+                irparams.OverflowFlag = false;
+                irparams.rawlen = 0;
+                storeCarrierEnvelopeDuration(tDeltaMicros); // the gap
+                sIRCarrierMeasurement.MarkStartMicros = tMicros;
+                sIRCarrierMeasurement.LastPulseEndMicros = tMicros;
+                sIRCarrierMeasurement.PeriodSumMicros = 0;
+                sIRCarrierMeasurement.PeriodCount = 0;
+                sIRCarrierMeasurement.OnTimeSumMicros = 0;
+                sIRCarrierMeasurement.OnTimeCount = 0;
+                irparams.StateForISR = IR_REC_STATE_MARK;
+            }
+
+        } else if (irparams.StateForISR == IR_REC_STATE_MARK) {
+            if (tDeltaMicros <= IR_CARRIER_MAXIMUM_PERIOD_MICROS) {
+                // Next carrier pulse of the current mark
+                sIRCarrierMeasurement.PeriodSumMicros += tDeltaMicros;
+                sIRCarrierMeasurement.PeriodCount++;
+
+            } else if (tDeltaMicros > IR_CARRIER_SPACE_THRESHOLD_MICROS) {
+                /*
+                 * A space has ended here. Store mark and space duration, 2 entries are required.
+                 */
+                if (irparams.rawlen >= RAW_BUFFER_LENGTH - 1) {
+                    irparams.OverflowFlag = true;
+                    IR_STORE_RELEASE(irparams.StateForISR, IR_REC_STATE_STOP); // pass raw buffer to decode()
+                } else {
+                    storeCarrierEnvelopeDuration(sIRCarrierMeasurement.LastPulseEndMicros - sIRCarrierMeasurement.MarkStartMicros);
+                    storeCarrierEnvelopeDuration(tMicros - sIRCarrierMeasurement.LastPulseEndMicros);
+                    sIRCarrierMeasurement.MarkStartMicros = tMicros;
+                }
+            }
+            // Values between maximum period and space threshold are most likely caused by a missed edge and are ignored
+        }
+        // In state IR_REC_STATE_STOP we just keep track of the last pulse for the gap measurement
+        sIRCarrierMeasurement.LastPulseStartMicros = tMicros;
+
+    } else if (irparams.StateForISR == IR_REC_STATE_MARK) {
+        /*
+         * End of a carrier pulse
+         */
+        sIRCarrierMeasurement.OnTimeSumMicros += tMicros - sIRCarrierMeasurement.LastPulseStartMicros;
+        sIRCarrierMeasurement.OnTimeCount++;
+        sIRCarrierMeasurement.LastPulseEndMicros = tMicros;
+    }
+
+#if !defined(NO_LED_FEEDBACK_CODE)
+    if (FeedbackLEDControl.LedFeedbackEnabled == LED_FEEDBACK_ENABLED_FOR_RECEIVE) {
+        setFeedbackLED(irparams.StateForISR == IR_REC_STATE_MARK);
+    }
+#endif
+}
+
+/**
+ * Enables the edge interrupt at the receive pin. Used instead of timerEnableReceiveInterrupt().
+ */
+void enableCarrierEdgeInterrupt() {
+    sIRCarrierMeasurement.LastPulseStartMicros = micros();
+#if defined(NOT_AN_INTERRUPT)
+    if (digitalPinToInterrupt(irparams.IRReceivePin) == NOT_AN_INTERRUPT) {
+#  if defined(LOCAL_DEBUG)
+        Serial.println(F("Receive pin has no interrupt capability, USE_NON_DEMODULATING_RECEIVER does not work"));
+#  endif
+        return;
+    }
+#endif
+    attachInterrupt(digitalPinToInterrupt(irparams.IRReceivePin), IRCarrierEdgeInterruptHandler, CHANGE);
+}
+
+void disableCarrierEdgeInterrupt() {
+    detachInterrupt(digitalPinToInterrupt(irparams.IRReceivePin));
+}
+
+/**
+ * Since no edge occurs at the end of a frame, we must check the time since the last carrier pulse here.
+ * Is called by available(), decode() and isIdle(), so one of them must be polled in the loop.
+ * No receive complete callback is called, since this is not ISR context.
+ */
+void IRrecv::checkForEndOfCarrierFrame() {
+    noInterrupts();
+    if (irparams.StateForISR == IR_REC_STATE_MARK
+            && (micros() - sIRCarrierMeasurement.LastPulseStartMicros) > RECORD_GAP_MICROS) {
+        // store the last mark, the trailing space is not stored, like for the timer based receiving
+        storeCarrierEnvelopeDuration(sIRCarrierMeasurement.LastPulseEndMicros - sIRCarrierMeasurement.MarkStartMicros);
+        IR_STORE_RELEASE(irparams.StateForISR, IR_REC_STATE_STOP); // pass raw buffer to decode()
+    }
+    interrupts();
+}
+
+/**
+ * @return The carrier frequency averaged over all carrier pulses of the last received frame, or 0 if no carrier was detected.
+ *         Can be used as frequency parameter for compensateAndPrintIRResultAsPronto() and compensateAndStorePronto().
+ */
+uint32_t IRrecv::getCarrierFrequencyHertz() {
+    if (sIRCarrierMeasurement.PeriodSumMicros == 0) {
+        return 0;
+    }
+    // 64 bit, since 1000000 * PeriodCount overflows 32 bit after 4294 periods, i.e. 113 ms of marks at 38 kHz, which occurs for air conditioners
+    return (((uint64_t) MICROS_IN_ONE_SECOND * sIRCarrierMeasurement.PeriodCount) + (sIRCarrierMeasurement.PeriodSumMicros / 2))
+            / sIRCarrierMeasurement.PeriodSumMicros;
+}
+
+/**
+ * @return The carrier frequency in kHz to be used for sendRaw(), or 38 if no carrier was detected.
+ */
+uint_fast8_t IRrecv::getCarrierFrequencyKHz() {
+    uint32_t tFrequencyHertz = getCarrierFrequencyHertz();
+    if (tFrequencyHertz == 0) {
+        return 38;
+    }
+    return (tFrequencyHertz + 500) / 1000;
+}
+
+/**
+ * @return The carrier duty cycle in percent averaged over all carrier pulses of the last received frame, or 0 if no carrier was detected.
+ */
+uint8_t IRrecv::getCarrierDutyCyclePercent() {
+    if (sIRCarrierMeasurement.PeriodSumMicros == 0 || sIRCarrierMeasurement.OnTimeCount == 0) {
+        return 0;
+    }
+    // (OnTimeSum / OnTimeCount) * 100 / (PeriodSum / PeriodCount). Divide first, to avoid overflow for long frames.
+    uint32_t tMeanOnTimeMicrosTimes100 = (sIRCarrierMeasurement.OnTimeSumMicros * 100UL) / sIRCarrierMeasurement.OnTimeCount;
+    return ((tMeanOnTimeMicrosTimes100 * sIRCarrierMeasurement.PeriodCount) + (sIRCarrierMeasurement.PeriodSumMicros / 2))
+            / sIRCarrierMeasurement.PeriodSumMicros;
+}
+
+/**
+ * Prints carrier frequency and duty cycle of the last received frame e.g. "Carrier: 38123 Hz, duty cycle 33 %"
+ * @param aSerial The Print object on which to write, for Arduino you can use &Serial.
+ */
+void IRrecv::printCarrierInfo(Print *aSerial) {
+    aSerial->print(F("Carrier: "));
+    aSerial->print(getCarrierFrequencyHertz());
+    aSerial->print(F(" Hz, duty cycle "));
+    aSerial->print(getCarrierDutyCyclePercent());
+    aSerial->println(F(" %"));
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_CARRIER_MEASUREMENT_HPP
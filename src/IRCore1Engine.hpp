@@ -0,0 +1,114 @@
+/**
+ * @file IRCore1Engine.hpp
+ *
+ * @brief Runs receiving, decoding and sending on the second core of the RP2040.
+ * Call setupIREngineOnCore1() in setup1() and loopIREngineOnCore1() in loop1() of the arduino-pico core.
+ * The receive timer callback then runs on core 1, received frames are decoded on core 1 and the results are read on core 0 by IrReceiver.read().
+ * Send requests of core 0 are queued by sendOnCore1() and sent by core 1, so the blocking mark() loops no longer delay the application.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_CORE1_ENGINE_HPP
+#define _IR_CORE1_ENGINE_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Sending Sending IR data for multiple protocols
+ * @{
+ */
+
+/*
+ * Send requests from core 0 to core 1. Written only by sendOnCore1() and read only by loopIREngineOnCore1().
+ */
+struct IRCore1SendRequest {
+    decode_type_t Protocol;
+    uint16_t Address;
+    uint16_t Command;
+    int_fast8_t NumberOfRepeats;
+};
+IRCore1SendRequest sCore1SendQueue[IR_CORE1_SEND_QUEUE_SIZE];
+volatile uint8_t sCore1SendQueueReadIndex;
+volatile uint8_t sCore1SendQueueWriteIndex;
+
+/**
+ * Starts the receiver on core 1. Must be called in setup1().
+ * The receive timer uses its own alarm pool created here, so its callback runs on core 1.
+ * IrSender.begin() can be called as usual on core 0.
+ * @return false if the hardware alarm for the alarm pool is already claimed, receiving is then not possible.
+ */
+bool setupIREngineOnCore1(uint_fast8_t aReceivePin) {
+    IrReceiver.begin(aReceivePin);
+    return sIRAlarmPool != NULL;
+}
+
+/**
+ * Decodes all received frames and sends all queued requests. Must be called in loop1().
+ */
+void loopIREngineOnCore1() {
+    runIRPipeline();
+
+    uint8_t tReadIndex = sCore1SendQueueReadIndex;
+    while (tReadIndex != IR_LOAD_ACQUIRE(sCore1SendQueueWriteIndex)) {
+        IRCore1SendRequest *tRequest = &sCore1SendQueue[tReadIndex];
+        // The receive timer callback on this core would disturb the software generated carrier
+        IrReceiver.stop();
+        IrSender.write(tRequest->Protocol, tRequest->Address, tRequest->Command, tRequest->NumberOfRepeats);
+        IrReceiver.start();
+        tReadIndex = (tReadIndex + 1) % IR_CORE1_SEND_QUEUE_SIZE;
+        IR_STORE_RELEASE(sCore1SendQueueReadIndex, tReadIndex); // Request is sent, release it
+        runIRPipeline(); // Do not let results wait while sending a long queue
+    }
+}
+
+/**
+ * Queues a send request for core 1. Can be called on core 0 instead of IrSender.write().
+ * @return false if queue is full.
+ */
+bool sendOnCore1(decode_type_t aProtocol, uint16_t aAddress, uint16_t aCommand, int_fast8_t aNumberOfRepeats) {
+    uint8_t tWriteIndex = sCore1SendQueueWriteIndex;
+    uint8_t tNextWriteIndex = (tWriteIndex + 1) % IR_CORE1_SEND_QUEUE_SIZE;
+    if (tNextWriteIndex == IR_LOAD_ACQUIRE(sCore1SendQueueReadIndex)) {
+        return false;
+    }
+    IRCore1SendRequest *tRequest = &sCore1SendQueue[tWriteIndex];
+    tRequest->Protocol = aProtocol;
+    tRequest->Address = aAddress;
+    tRequest->Command = aCommand;
+    tRequest->NumberOfRepeats = aNumberOfRepeats;
+    IR_STORE_RELEASE(sCore1SendQueueWriteIndex, tNextWriteIndex); // Publish request only after it is completely written
+    return true;
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_CORE1_ENGINE_HPP
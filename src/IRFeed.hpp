@@ -0,0 +1,215 @@
+/**
+ * @file IRFeed.hpp
+ *
+ * @brief Receiving from recorded durations or PCM samples instead of the receive pin.
+ * feedDuration() runs the same state machine as the receive ISR, but with mark and space durations.
+ * feedPCMSample() converts the samples of a recording of the receiver output, e.g. a WAV file read from SD card,
+ * to durations by a threshold with hysteresis. Both work on a stream, so recordings of any length can be decoded with the usual raw buffer.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_FEED_HPP
+#define _IR_FEED_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Receiving Receiving IR data for multiple protocols
+ * @{
+ */
+
+/*
+ * Data for converting PCM samples to durations
+ */
+struct IRPCMFeedStruct {
+    uint32_t MicrosPerSampleShift8; // Micros per sample * 256
+    uint16_t SamplesForRecordGap; // Number of space samples after which the end of frame is signaled
+    int16_t LowThreshold; // Samples <= LowThreshold are low
+    int16_t HighThreshold; // Samples >= HighThreshold are high, samples in between keep the last level
+    bool MarkIsLow; // true for the active low output of a demodulating receiver
+    bool IsMark; // Level of the current samples
+    uint16_t NumberOfSamples; // Number of samples of the current level, clipped at UINT16_MAX
+};
+IRPCMFeedStruct sIRPCMFeed;
+
+/*
+ * Called if state is set to IR_REC_STATE_STOP, like in the receive ISR
+ */
+static void handleEndOfFedFrame() {
+#if defined(ENABLE_IR_PIPELINE)
+    copyFrameToPipeline();
+#endif
+#if !IR_REMOTE_DISABLE_RECEIVE_COMPLETE_CALLBACK
+    if (irparams.ReceiveCompleteCallbackFunction != NULL) {
+        irparams.ReceiveCompleteCallbackFunction();
+    }
+#endif
+}
+
+/**
+ * Feeds one mark or space duration to the receive state machine.
+ * The receiver must not be started by begin() or start(), or must be stopped by stop() before, since the ISR uses the same raw buffer.
+ * Successive durations of the same level are added. A space longer than RECORD_GAP_MICROS ends the frame.
+ * To end the last frame of a recording, feed a space of RECORD_GAP_MICROS + MICROS_PER_TICK.
+ * @return true if a frame is complete and can be decoded by decode(). Call resume() after decoding, else all following durations are ignored.
+ */
+bool IRrecv::feedDuration(bool aIsMark, uint32_t aDurationMicros) {
+    uint32_t tTicks;
+    if (aDurationMicros >= (uint32_t) UINT16_MAX * MICROS_PER_TICK) {
+        tTicks = UINT16_MAX; // Saturate before rounding, which could overflow for e.g. UINT32_MAX
+    } else {
+        tTicks = (aDurationMicros + (MICROS_PER_TICK / 2)) / MICROS_PER_TICK;
+    }
+    uint_fast8_t tStateForISR = irparams.StateForISR;
+
+    if (aIsMark) {
+        if (tStateForISR == IR_REC_STATE_IDLE) {
+            // check if we did not start in the middle of a transmission by checking the minimum length of leading space
+            if (irparams.TickCounterForISR > RECORD_GAP_TICKS) {
+                irparams.OverflowFlag = false;
+                irparams.rawbuf[0] = irparams.TickCounterForISR;
+                irparams.rawbuf[1] = tTicks;
+                irparams.rawlen = 2;
+                irparams.StateForISR = IR_REC_STATE_MARK;
+            }
+            irparams.TickCounterForISR = 0;
+
+        } else if (tStateForISR == IR_REC_STATE_MARK) {
+            uint32_t tSum = irparams.rawbuf[irparams.rawlen - 1] + tTicks;
+            irparams.rawbuf[irparams.rawlen - 1] = (tSum > UINT16_MAX) ? UINT16_MAX : tSum;
+
+        } else if (tStateForISR == IR_REC_STATE_SPACE) {
+            // There is always room for a mark, since spaces are stored at even indexes and RAW_BUFFER_LENGTH is even
+            irparams.rawbuf[irparams.rawlen++] = tTicks;
+            irparams.StateForISR = IR_REC_STATE_MARK;
+
+        } else {
+            // IR_REC_STATE_STOP, prepare gap detection for the next frame after resume()
+            irparams.TickCounterForISR = 0;
+            return true;
+        }
+        return false;
+    }
+
+    /*
+     * Space here
+     */
+    if (tStateForISR == IR_REC_STATE_MARK) {
+        if (tTicks > RECORD_GAP_TICKS) {
+            irparams.TickCounterForISR = tTicks; // The gap of the next frame
+            irparams.StateForISR = IR_REC_STATE_STOP;
+            handleEndOfFedFrame();
+        } else if (irparams.rawlen >= RAW_BUFFER_LENGTH) {
+            irparams.OverflowFlag = true;
+            irparams.TickCounterForISR = 0;
+            irparams.StateForISR = IR_REC_STATE_STOP;
+            handleEndOfFedFrame();
+        } else {
+            irparams.rawbuf[irparams.rawlen++] = tTicks;
+            irparams.StateForISR = IR_REC_STATE_SPACE;
+        }
+
+    } else if (tStateForISR == IR_REC_STATE_SPACE) {
+        uint32_t tSum = irparams.rawbuf[irparams.rawlen - 1] + tTicks;
+        if (tSum > RECORD_GAP_TICKS) {
+            // The last space was the start of the gap
+            irparams.rawlen--;
+            irparams.TickCounterForISR = (tSum > UINT16_MAX) ? UINT16_MAX : tSum;
+            irparams.StateForISR = IR_REC_STATE_STOP;
+            handleEndOfFedFrame();
+        } else {
+            irparams.rawbuf[irparams.rawlen - 1] = tSum;
+        }
+
+    } else {
+        // IR_REC_STATE_IDLE or IR_REC_STATE_STOP, count the gap
+        uint32_t tSum = irparams.TickCounterForISR + tTicks;
+        irparams.TickCounterForISR = (tSum > UINT16_MAX) ? UINT16_MAX : tSum;
+    }
+    return (irparams.StateForISR == IR_REC_STATE_STOP);
+}
+
+/**
+ * Sets the parameters for feedPCMSample() and resets the conversion.
+ * @param aSampleRateHertz  Sample rate of the recording. Should be at least 8 kHz, better 20 kHz or more.
+ * @param aLowThreshold     Samples less than or equal are taken as low.
+ * @param aHighThreshold    Samples greater than or equal are taken as high. Samples in between keep the last level (hysteresis).
+ * @param aMarkIsLow        true for a recording of the active low output of a demodulating receiver module.
+ */
+void IRrecv::setPCMFeedParameters(uint32_t aSampleRateHertz, int16_t aLowThreshold, int16_t aHighThreshold, bool aMarkIsLow) {
+    sIRPCMFeed.MicrosPerSampleShift8 = (MICROS_IN_ONE_SECOND * 256UL) / aSampleRateHertz;
+    sIRPCMFeed.SamplesForRecordGap = ((RECORD_GAP_MICROS + MICROS_PER_TICK) * 256UL) / sIRPCMFeed.MicrosPerSampleShift8;
+    sIRPCMFeed.LowThreshold = aLowThreshold;
+    sIRPCMFeed.HighThreshold = aHighThreshold;
+    sIRPCMFeed.MarkIsLow = aMarkIsLow;
+    sIRPCMFeed.IsMark = false;
+    sIRPCMFeed.NumberOfSamples = 0;
+}
+
+/**
+ * Feeds one sample of a mono PCM recording of the receiver output.
+ * Convert 8 bit WAV samples to signed 16 bit by ((int16_t) aSample - 128) << 8, 16 bit samples can be fed directly.
+ * The WAV header is not parsed here. The samples start after the 8 byte header of the "data" chunk,
+ * which is at offset 36 only for the canonical format. Files with e.g. "LIST" or "fact" chunks before it
+ * require to skip the chunks by their size fields until the "data" chunk is found.
+ * @return true if a frame is complete and can be decoded by decode(). Call resume() after decoding.
+ */
+bool IRrecv::feedPCMSample(int16_t aSample) {
+    bool tIsMark = sIRPCMFeed.IsMark;
+    if (aSample <= sIRPCMFeed.LowThreshold) {
+        tIsMark = sIRPCMFeed.MarkIsLow;
+    } else if (aSample >= sIRPCMFeed.HighThreshold) {
+        tIsMark = !sIRPCMFeed.MarkIsLow;
+    }
+
+    if (tIsMark == sIRPCMFeed.IsMark) {
+        if (sIRPCMFeed.NumberOfSamples < UINT16_MAX) {
+            sIRPCMFeed.NumberOfSamples++;
+        }
+        if (!tIsMark && sIRPCMFeed.NumberOfSamples >= sIRPCMFeed.SamplesForRecordGap) {
+            // Signal end of frame now, not at the next mark, which may come hours later
+            uint16_t tNumberOfSamples = sIRPCMFeed.NumberOfSamples;
+            sIRPCMFeed.NumberOfSamples = 0;
+            return feedDuration(false, (tNumberOfSamples * sIRPCMFeed.MicrosPerSampleShift8) >> 8);
+        }
+        return false;
+    }
+
+    uint16_t tNumberOfSamples = sIRPCMFeed.NumberOfSamples;
+    sIRPCMFeed.IsMark = tIsMark;
+    sIRPCMFeed.NumberOfSamples = 1;
+    return feedDuration(!tIsMark, (tNumberOfSamples * sIRPCMFeed.MicrosPerSampleShift8) >> 8);
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_FEED_HPP
@@ -0,0 +1,243 @@
+/**
+ * @file IRLearning.hpp
+ *
+ * @brief Learning of raw IR codes from multiple captures of the same button.
+ * Each capture carries the distortion of the receiver at the moment of capturing.
+ * Captures are aligned by their length, outliers are rejected and for each interval the median is taken.
+ * The result is compensated with MARK_EXCESS_MICROS and stored in the compact 8 bit tick format used by sendRaw().
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_LEARNING_HPP
+#define _IR_LEARNING_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Receiving Receiving IR data for multiple protocols
+ * @{
+ */
+
+/**
+ * Captures stored for learning. Uses IR_LEARNING_NUMBER_OF_CAPTURES * RAW_BUFFER_LENGTH bytes of RAM.
+ * The (uncompensated) ticks are clipped to 8 bit, which is sufficient, since RECORD_GAP_MICROS is 5 ms.
+ */
+struct IRLearningStruct {
+    uint8_t NumberOfCaptures;
+#if RAW_BUFFER_LENGTH <= 254
+    uint8_t Length[IR_LEARNING_NUMBER_OF_CAPTURES]; ///< Number of intervals, i.e. rawlen - 1, since the leading gap is not stored
+#else
+    uint16_t Length[IR_LEARNING_NUMBER_OF_CAPTURES];
+#endif
+    uint8_t Ticks[IR_LEARNING_NUMBER_OF_CAPTURES][RAW_BUFFER_LENGTH - 1];
+};
+IRLearningStruct sIRLearning;
+
+/**
+ * Discards all captures stored so far.
+ */
+void IRrecv::startLearning() {
+    sIRLearning.NumberOfCaptures = 0;
+}
+
+/**
+ * Stores the current raw data as one capture for learning.
+ * Call it after decode() returned true, before resume().
+ * Overflow frames and frames shorter than 4 entries (e.g. noise) are not stored.
+ * @return Number of captures stored so far. IR_LEARNING_NUMBER_OF_CAPTURES if no more captures can be stored.
+ */
+uint8_t IRrecv::addCaptureForLearning() {
+    uint8_t tIndex = sIRLearning.NumberOfCaptures;
+    if (tIndex >= IR_LEARNING_NUMBER_OF_CAPTURES || (decodedIRData.flags & IRDATA_FLAGS_WAS_OVERFLOW)
+            || decodedIRData.rawDataPtr->rawlen < 4) {
+        return tIndex;
+    }
+    uint_fast16_t tLength = decodedIRData.rawDataPtr->rawlen - 1;
+    sIRLearning.Length[tIndex] = tLength;
+    for (uint_fast16_t i = 0; i < tLength; i++) {
+        uint16_t tTicks = decodedIRData.rawDataPtr->rawbuf[i + 1]; // skip leading gap
+        sIRLearning.Ticks[tIndex][i] = (tTicks > UINT8_MAX) ? UINT8_MAX : tTicks;
+    }
+    sIRLearning.NumberOfCaptures = tIndex + 1;
+    return tIndex + 1;
+}
+
+/*
+ * Returns the median of the values of one interval of all captures selected by aCaptureMask.
+ * For an even number of values the mean of the 2 middle values is returned.
+ */
+static uint8_t getMedianTicksOfInterval(uint_fast16_t aIntervalIndex, uint16_t aCaptureMask) {
+    uint8_t tSortedTicks[IR_LEARNING_NUMBER_OF_CAPTURES];
+    uint_fast8_t tCount = 0;
+    for (uint_fast8_t tCapture = 0; tCapture < sIRLearning.NumberOfCaptures; tCapture++) {
+        if (aCaptureMask & (1 << tCapture)) {
+            // insertion sort, we have only a few values
+            uint8_t tTicks = sIRLearning.Ticks[tCapture][aIntervalIndex];
+            uint_fast8_t j = tCount;
+            while (j > 0 && tSortedTicks[j - 1] > tTicks) {
+                tSortedTicks[j] = tSortedTicks[j - 1];
+                j--;
+            }
+            tSortedTicks[j] = tTicks;
+            tCount++;
+        }
+    }
+    if (tCount & 1) {
+        return tSortedTicks[tCount / 2];
+    }
+    return (tSortedTicks[(tCount / 2) - 1] + tSortedTicks[tCount / 2] + 1) / 2;
+}
+
+/**
+ * Computes the canonical timing of all stored captures.
+ * 1. Only captures with the most frequent length are used, the others are taken as broken or as repeat frames.
+ * 2. A capture, which has an interval deviating more than TOLERANCE_FOR_DECODERS_MARK_OR_SPACE_MATCHING percent
+ *    from the median of the interval is rejected as outlier.
+ * 3. Each interval is the median of the remaining captures, compensated by MARK_EXCESS_MICROS.
+ *
+ * @param aArrayPtr Address of an array of at least RAW_BUFFER_LENGTH - 1 bytes provided by the caller.
+ *                  The content can directly be used for sendRaw(aArrayPtr, <return value>, <kHz>).
+ * @return Number of entries stored in aArrayPtr, or 0 if less than half of the captures are consistent.
+ */
+uint_fast16_t IRrecv::computeLearnedTicks(uint8_t *aArrayPtr) {
+    uint_fast8_t tNumberOfCaptures = sIRLearning.NumberOfCaptures;
+    if (tNumberOfCaptures == 0) {
+        return 0;
+    }
+
+    /*
+     * Find the most frequent length
+     */
+    uint_fast16_t tLength = 0;
+    uint_fast8_t tMaxCount = 0;
+    for (uint_fast8_t i = 0; i < tNumberOfCaptures; i++) {
+        uint_fast8_t tCount = 0;
+        for (uint_fast8_t j = 0; j < tNumberOfCaptures; j++) {
+            if (sIRLearning.Length[j] == sIRLearning.Length[i]) {
+                tCount++;
+            }
+        }
+        if (tCount > tMaxCount) {
+            tMaxCount = tCount;
+            tLength = sIRLearning.Length[i];
+        }
+    }
+    uint16_t tCaptureMask = 0;
+    for (uint_fast8_t i = 0; i < tNumberOfCaptures; i++) {
+        if (sIRLearning.Length[i] == tLength) {
+            tCaptureMask |= 1 << i;
+        }
+    }
+
+    /*
+     * Reject captures with intervals deviating too much from the median
+     */
+    uint16_t tGoodCaptureMask = tCaptureMask;
+    for (uint_fast16_t i = 0; i < tLength; i++) {
+        uint8_t tMedianTicks = getMedianTicksOfInterval(i, tCaptureMask);
+        uint16_t tMaximumDeviation = ((tMedianTicks * TOLERANCE_FOR_DECODERS_MARK_OR_SPACE_MATCHING) / 100) + 1; // +1 for tick resolution
+        for (uint_fast8_t tCapture = 0; tCapture < tNumberOfCaptures; tCapture++) {
+            if (tGoodCaptureMask & (1 << tCapture)) {
+                int16_t tDeviation = (int16_t) sIRLearning.Ticks[tCapture][i] - tMedianTicks;
+                if (abs(tDeviation) > (int16_t) tMaximumDeviation) {
+                    tGoodCaptureMask &= ~(1 << tCapture);
+#if defined(LOCAL_DEBUG)
+                    Serial.print(F("Reject capture "));
+                    Serial.print(tCapture);
+                    Serial.print(F(" at index "));
+                    Serial.println(i);
+#endif
+                }
+            }
+        }
+    }
+
+    uint_fast8_t tNumberOfGoodCaptures = 0;
+    for (uint_fast8_t i = 0; i < tNumberOfCaptures; i++) {
+        if (tGoodCaptureMask & (1 << i)) {
+            tNumberOfGoodCaptures++;
+        }
+    }
+    if (tNumberOfGoodCaptures * 2 < tNumberOfCaptures) {
+        return 0;
+    }
+
+    /*
+     * Compute compensated medians
+     */
+    for (uint_fast16_t i = 0; i < tLength; i++) {
+        int32_t tDuration = getMedianTicksOfInterval(i, tGoodCaptureMask) * MICROS_PER_TICK;
+        if (i & 1) {
+            tDuration += MARK_EXCESS_MICROS; // Space, since we do not store the leading gap
+        } else {
+            tDuration -= MARK_EXCESS_MICROS; // Mark
+        }
+        if (tDuration < 0) {
+            tDuration = 0;
+        }
+        unsigned int tTicks = (tDuration + (MICROS_PER_TICK / 2)) / MICROS_PER_TICK;
+        aArrayPtr[i] = (tTicks > UINT8_MAX) ? UINT8_MAX : tTicks;
+    }
+    return tLength;
+}
+
+/**
+ * Print the learned ticks as C array to be used for sendRaw().
+ * @param aSerial The Print object on which to write, for Arduino you can use &Serial.
+ * @param aArrayPtr Temporary array of at least RAW_BUFFER_LENGTH - 1 bytes provided by the caller.
+ */
+void IRrecv::printLearnedTicksAsCArray(Print *aSerial, uint8_t *aArrayPtr) {
+    uint_fast16_t tLength = computeLearnedTicks(aArrayPtr);
+    if (tLength == 0) {
+        aSerial->println(F("Captures are not consistent, learning failed"));
+        return;
+    }
+    aSerial->print(F("uint8_t rawTicks["));
+    aSerial->print(tLength);
+    aSerial->print(F("] = {"));
+    for (uint_fast16_t i = 0; i < tLength; i++) {
+        aSerial->print(aArrayPtr[i]);
+        if (i + 1 < tLength) {
+            aSerial->print(',');
+            if (i & 1) {
+                aSerial->print(' ');
+            }
+        }
+    }
+    aSerial->print(F("};  // learned from "));
+    aSerial->print(sIRLearning.NumberOfCaptures);
+    aSerial->println(F(" captures"));
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_LEARNING_HPP
@@ -0,0 +1,115 @@
+/**
+ * @file IRPipeline.hpp
+ *
+ * @brief Decoding of received frames in a separate task.
+ * The ISR copies each received frame into a ring of raw frames and restarts receiving immediately.
+ * The decode task takes the frames from this ring, decodes them and stores the results in the result FIFO,
+ * from where the application reads them by IrReceiver.read().
+ * The task is created with FreeRTOS for ESP32 and RP2040 with FreeRTOS, and with an rtos::Thread for mbed boards.
+ * On other platforms, call runIRPipeline() in your loop. There is no POSIX threads backend.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_PIPELINE_HPP
+#define _IR_PIPELINE_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+#if defined(ARDUINO_ARCH_MBED)
+#include <mbed.h>
+#elif defined(ARDUINO_ARCH_RP2040) && defined(__FREERTOS)
+#include <FreeRTOS.h>
+#include <task.h>
+#endif
+
+/** \addtogroup Receiving Receiving IR data for multiple protocols
+ * @{
+ */
+
+/**
+ * Decodes all frames of the frame ring and stores the results in the result FIFO.
+ * This is the body of the decode task. Call it in your loop, if you do not use startIRPipelineTask().
+ */
+void runIRPipeline() {
+    while (sPipelineFramesReadIndex != IR_LOAD_ACQUIRE(sPipelineFramesWriteIndex)) {
+        decodeToResultFifo(); // calls resume(), which releases the frame
+    }
+}
+
+#if defined(ESP32) || (defined(ARDUINO_ARCH_RP2040) && defined(__FREERTOS))
+static void IRPipelineTask(void *aParameter) {
+    (void) aParameter;
+    for (;;) {
+        runIRPipeline();
+        vTaskDelay(1); // Frames are at least RECORD_GAP_MICROS apart, so polling every tick is sufficient
+    }
+}
+
+/**
+ * Creates the decode task. Call it after IrReceiver.begin().
+ * On ESP32 the task is pinned to the current core, which is the core running the receive timer interrupt.
+ * @return false if task could not be created or no RTOS is available.
+ */
+bool startIRPipelineTask() {
+#  if defined(ESP32)
+    return xTaskCreatePinnedToCore(IRPipelineTask, "IRPipeline", IR_PIPELINE_TASK_STACK_SIZE, NULL, IR_PIPELINE_TASK_PRIORITY, NULL,
+            xPortGetCoreID()) == pdPASS;
+#  else
+    return xTaskCreate(IRPipelineTask, "IRPipeline", IR_PIPELINE_TASK_STACK_SIZE / sizeof(StackType_t), NULL,
+            IR_PIPELINE_TASK_PRIORITY, NULL) == pdPASS;
+#  endif
+}
+
+#elif defined(ARDUINO_ARCH_MBED)
+rtos::Thread sIRPipelineThread(osPriorityAboveNormal, IR_PIPELINE_TASK_STACK_SIZE);
+
+static void IRPipelineThread() {
+    for (;;) {
+        runIRPipeline();
+        thread_sleep_for(1); // Frames are at least RECORD_GAP_MICROS apart, so polling every ms is sufficient
+    }
+}
+
+bool startIRPipelineTask() {
+    return sIRPipelineThread.start(IRPipelineThread) == osOK;
+}
+
+#else
+bool startIRPipelineTask() {
+    return false; // No RTOS available, runIRPipeline() must be called in loop
+}
+#endif
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_PIPELINE_HPP
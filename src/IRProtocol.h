@@ -131,6 +131,61 @@ struct PulseDistanceWidthProtocolConstants {
     void (*SpecialSendRepeatFunction)(); // using non member functions here saves up to 250 bytes for send demo
 //    void (IRsend::*SpecialSendRepeatFunction)();
 };
+/**
+ * Window of accepted tick values for a mark or a space, precomputed to save the TICKS_LOW() and TICKS_HIGH() computations while decoding.
+ */
+struct IRTickWindow {
+    uint16_t MinTicks;
+    uint16_t MaxTicks;
+};
+#define IR_MARK_TICK_WINDOW(aMarkMicros)    { TICKS_LOW((aMarkMicros) + MARK_EXCESS_MICROS), TICKS_HIGH((aMarkMicros) + MARK_EXCESS_MICROS) }
+#define IR_SPACE_TICK_WINDOW(aSpaceMicros)  { TICKS_LOW((aSpaceMicros) - MARK_EXCESS_MICROS), TICKS_HIGH((aSpaceMicros) - MARK_EXCESS_MICROS) }
+/**
+ * Tick windows for the members HeaderMarkTicks to ZeroSpaceTicks of IRProtocolDescriptor, computed at compile time.
+ * Parameters are in the order of DistanceWidthTimingInfoStruct.
+ */
+#define IR_DESCRIPTOR_TICK_WINDOWS(aHeaderMarkMicros, aHeaderSpaceMicros, aOneMarkMicros, aOneSpaceMicros, aZeroMarkMicros, aZeroSpaceMicros) \
+    IR_MARK_TICK_WINDOW(aHeaderMarkMicros), IR_SPACE_TICK_WINDOW(aHeaderSpaceMicros), \
+    IR_MARK_TICK_WINDOW(aOneMarkMicros), IR_SPACE_TICK_WINDOW(aOneSpaceMicros), \
+    IR_MARK_TICK_WINDOW(aZeroMarkMicros), IR_SPACE_TICK_WINDOW(aZeroSpaceMicros)
+
+/**
+ * Descriptor of a pulse distance or pulse width protocol for the generic descriptor decoder and encoder, see ir_Descriptor.hpp.
+ * This is the data a converter from IRP notation generates, e.g. for NEC {38k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,^108m)
+ * The data bits consist of the address bits, followed by the command bits, followed by the extra bits. Each part has at most 16 bits.
+ * Biphase descriptors have at most 32 data bits. loadDescriptor() rejects descriptors violating these limits,
+ * descriptors in a PROGMEM table are not checked.
+ */
+struct IRProtocolDescriptor {
+    PulseDistanceWidthProtocolConstants ProtocolConstants; ///< ProtocolIndex is returned in decodedIRData.protocol
+    uint8_t NumberOfBits; ///< Number of data bits without stop bit, at most BITS_IN_RAW_DATA_TYPE and at most 32 for biphase
+    uint8_t NumberOfAddressBits;
+    uint8_t NumberOfCommandBits;
+    uint8_t DescriptorFlags; ///< IR_DESCRIPTOR_FLAGS_*
+    IRTickWindow HeaderMarkTicks;
+    IRTickWindow HeaderSpaceTicks;
+    IRTickWindow OneMarkTicks;
+    IRTickWindow OneSpaceTicks;
+    IRTickWindow ZeroMarkTicks;
+    IRTickWindow ZeroSpaceTicks;
+    uint16_t RepeatHeaderSpaceMicros; ///< If not 0, repeats are sent as header mark, this space and a stop bit, like NEC
+    IRTickWindow RepeatHeaderSpaceTicks;
+};
+/*
+ * Definitions for member IRProtocolDescriptor.DescriptorFlags
+ */
+#define IR_DESCRIPTOR_FLAGS_EXTRA_IS_INVERTED_COMMAND   0x01 ///< The extra bits are the inverted command, like ~F in IRP. Checked by decoder, generated by encoder.
+#define IR_DESCRIPTOR_FLAGS_BIPHASE         0x02 ///< Biphase (Manchester) encoding like RC5 with OneMarkMicros as time unit. Data is MSB first and has no header.
+#define IR_DESCRIPTOR_FLAGS_EVEN_PARITY     0x04 ///< The last data bit is the even parity of all other data bits. It is not part of address, command or extra.
+#define IR_DESCRIPTOR_FLAGS_ODD_PARITY      0x08 ///< The last data bit is the odd parity of all other data bits. It is not part of address, command or extra.
+
+/*
+ * Serialized descriptor as stored in EEPROM or FLASH for IrReceiver.loadDescriptor(). All 16 bit values are stored low byte first.
+ * ProtocolIndex, FrequencyKHz, HeaderMarkMicros16, HeaderSpaceMicros16, OneMarkMicros16, OneSpaceMicros16, ZeroMarkMicros16, ZeroSpaceMicros16,
+ * Flags, RepeatPeriodMillis16, NumberOfBits, NumberOfAddressBits, NumberOfCommandBits, DescriptorFlags, RepeatHeaderSpaceMicros16
+ */
+#define IR_SERIALIZED_DESCRIPTOR_SIZE       23
+
 /*
  * Definitions for member PulseDistanceWidthProtocolConstants.Flags
  */
@@ -68,6 +68,60 @@ IRrecv IrReceiver;
  */
 struct irparams_struct irparams; // the irparams instance
 
+#if defined(ENABLE_IR_RESULT_FIFO)
+/*
+ * Compact decoded results, written by decodeToResultFifo() and read by read()
+ */
+struct IRResultFifoEntry {
+    decode_type_t protocol;
+    uint16_t address;
+    uint16_t command;
+    uint16_t extra;
+    IRRawDataType decodedRawData;
+    uint8_t numberOfBits;
+    uint8_t flags;
+};
+IRResultFifoEntry sResultFifo[IR_RESULT_FIFO_SIZE];
+volatile uint8_t sResultFifoReadIndex;
+volatile uint8_t sResultFifoWriteIndex;
+IRData sResultFifoReadData; // The data returned by read()
+#endif
+
+#if defined(ENABLE_IR_PIPELINE)
+/*
+ * Ring of received raw frames, written by the ISR and read by decode().
+ * The receiver is restarted directly after a frame is copied, so no frame is lost while decoding the previous one.
+ */
+irparams_struct sPipelineFrames[IR_PIPELINE_NUMBER_OF_FRAMES];
+volatile uint8_t sPipelineFramesReadIndex;
+volatile uint8_t sPipelineFramesWriteIndex;
+bool sPipelineFrameIsInDecode; // true if decode() returned the frame at sPipelineFramesReadIndex and resume() was not yet called
+
+/*
+ * Called at the end of a frame, i.e. with state IR_REC_STATE_STOP.
+ * Copies the frame to the frame ring and restarts the receiver.
+ * If the ring is full, the receiver stays stopped and the frame is copied by resume() after the oldest frame is released.
+ */
+#if defined(ESP8266) || defined(ESP32)
+IRAM_ATTR
+#endif
+void copyFrameToPipeline() {
+    uint8_t tWriteIndex = sPipelineFramesWriteIndex;
+    uint8_t tNextWriteIndex = (tWriteIndex + 1) % IR_PIPELINE_NUMBER_OF_FRAMES;
+    if (tNextWriteIndex == IR_LOAD_ACQUIRE(sPipelineFramesReadIndex)) {
+        return;
+    }
+    irparams_struct *tFrame = &sPipelineFrames[tWriteIndex];
+    tFrame->OverflowFlag = irparams.OverflowFlag;
+    tFrame->rawlen = irparams.rawlen;
+    for (uint_fast16_t i = 0; i < irparams.rawlen; i++) {
+        tFrame->rawbuf[i] = irparams.rawbuf[i];
+    }
+    IR_STORE_RELEASE(sPipelineFramesWriteIndex, tNextWriteIndex); // Publish frame only after it is completely written
+    IR_STORE_RELEASE(irparams.StateForISR, IR_REC_STATE_IDLE); // Don't reset TickCounterForISR; keep counting width of next leading space
+}
+#endif
+
 /**
  * Instantiate the IRrecv class. Multiple instantiation is not supported.
  * @param IRReceivePin Arduino pin to use. No sanity check is made.
@@ -141,6 +195,10 @@ void IRReceiveTimerInterruptHandler() {
     uint_fast8_t tIRInputLevel = (uint_fast8_t) digitalReadFast(irparams.IRReceivePin);
 #endif
 
+#if defined(ENABLE_IR_REPEATER)
+    handleRepeaterTick(tIRInputLevel == INPUT_MARK);
+#endif
+
     /*
      * Increase TickCounter and clip it at maximum 0xFFFF / 3.2 seconds at 50 us ticks
      */
@@ -154,7 +212,8 @@ void IRReceiveTimerInterruptHandler() {
      */
 //    switch (irparams.StateForISR) {
 //
-    if (irparams.StateForISR == IR_REC_STATE_IDLE) {
+    uint_fast8_t tStateForISR = IR_LOAD_ACQUIRE(irparams.StateForISR); // acquire the raw buffer released by resume()
+    if (tStateForISR == IR_REC_STATE_IDLE) {
         /*
          * Here we are just resumed and maybe in the middle of a transmission
          */
@@ -176,7 +235,7 @@ void IRReceiveTimerInterruptHandler() {
             irparams.TickCounterForISR = 0; // reset counter in both cases
         }
 
-    } else if (irparams.StateForISR == IR_REC_STATE_MARK) {  // Timing mark
+    } else if (tStateForISR == IR_REC_STATE_MARK) {  // Timing mark
         if (tIRInputLevel != INPUT_MARK) {
             /*
              * Mark ended here. Record mark time in rawbuf array
@@ -189,7 +248,7 @@ void IRReceiveTimerInterruptHandler() {
             irparams.TickCounterForISR = 0; // This resets the tick counter also at end of frame :-)
         }
 
-    } else if (irparams.StateForISR == IR_REC_STATE_SPACE) {  // Timing space
+    } else if (tStateForISR == IR_REC_STATE_SPACE) {  // Timing space
         if (tIRInputLevel == INPUT_MARK) {
             /*
              * Space ended here. Check for overflow and record space time in rawbuf array
@@ -197,7 +256,10 @@ void IRReceiveTimerInterruptHandler() {
             if (irparams.rawlen >= RAW_BUFFER_LENGTH) {
                 // Flag up a read OverflowFlag; Stop the state machine
                 irparams.OverflowFlag = true;
-                irparams.StateForISR = IR_REC_STATE_STOP;
+                IR_STORE_RELEASE(irparams.StateForISR, IR_REC_STATE_STOP); // pass raw buffer to decode()
+#if defined(ENABLE_IR_PIPELINE)
+                copyFrameToPipeline();
+#endif
 #if !IR_REMOTE_DISABLE_RECEIVE_COMPLETE_CALLBACK
                 /*
                  * Call callback if registered (not NULL)
@@ -223,7 +285,10 @@ void IRReceiveTimerInterruptHandler() {
              * Switch to IR_REC_STATE_STOP
              * Don't reset TickCounterForISR; keep counting width of next leading space
              */
-            irparams.StateForISR = IR_REC_STATE_STOP;
+            IR_STORE_RELEASE(irparams.StateForISR, IR_REC_STATE_STOP); // pass raw buffer to decode()
+#if defined(ENABLE_IR_PIPELINE)
+            copyFrameToPipeline();
+#endif
 #if !IR_REMOTE_DISABLE_RECEIVE_COMPLETE_CALLBACK
             /*
              * Call callback if registered (not NULL)
@@ -233,7 +298,7 @@ void IRReceiveTimerInterruptHandler() {
             }
 #endif
         }
-    } else if (irparams.StateForISR == IR_REC_STATE_STOP) {
+    } else if (tStateForISR == IR_REC_STATE_STOP) {
         /*
          * Complete command received
          * stay here until resume() is called, which switches state to IR_REC_STATE_IDLE
@@ -316,12 +381,14 @@ void IRrecv::setReceivePin(uint_fast8_t aReceivePinNumber) {
     pinMode(aReceivePinNumber, INPUT); // Seems to be at least required by ESP32
 }
 
+#if !defined(USE_NON_DEMODULATING_RECEIVER)
 /**
  * Sets the function to call if a protocol message has arrived
  */
 void IRrecv::registerReceiveCompleteCallback(void (*aReceiveCompleteCallbackFunction)(void)) {
     irparams.ReceiveCompleteCallbackFunction = aReceiveCompleteCallbackFunction;
 }
+#endif
 
 /**
  * Start the receiving process.
@@ -330,6 +397,12 @@ void IRrecv::registerReceiveCompleteCallback(void (*aReceiveCompleteCallbackFunc
  */
 void IRrecv::start() {
 
+#if defined(USE_NON_DEMODULATING_RECEIVER)
+    // Initialize state machine state
+    resume();
+    // No timer required, every carrier pulse triggers an interrupt
+    enableCarrierEdgeInterrupt();
+#else
     // Setup for cyclic 50 us interrupt
     timerConfigForReceive(); // no interrupts enabled here!
 
@@ -338,6 +411,7 @@ void IRrecv::start() {
 
     // Timer interrupt is enabled after state machine reset
     timerEnableReceiveInterrupt(); // Enables the receive sample timer interrupt which consumes a small amount of CPU every 50 us.
+#endif
 #ifdef _IR_MEASURE_TIMING
     pinModeFast(_IR_TIMING_TEST_PIN, OUTPUT);
 #endif
@@ -383,7 +457,11 @@ void IRrecv::restartAfterSend() {
  * Disables the timer for IR reception.
  */
 void IRrecv::stop() {
+#if defined(USE_NON_DEMODULATING_RECEIVER)
+    disableCarrierEdgeInterrupt();
+#else
     timerDisableReceiveInterrupt();
+#endif
 }
 /**
  * Alias for stop().
@@ -403,7 +481,11 @@ void IRrecv::end() {
  * @return true if no reception is on-going.
  */
 bool IRrecv::isIdle() {
-    return (irparams.StateForISR == IR_REC_STATE_IDLE || irparams.StateForISR == IR_REC_STATE_STOP) ? true : false;
+#if defined(USE_NON_DEMODULATING_RECEIVER)
+    checkForEndOfCarrierFrame();
+#endif
+    uint_fast8_t tStateForISR = IR_LOAD_ACQUIRE(irparams.StateForISR);
+    return (tStateForISR == IR_REC_STATE_IDLE || tStateForISR == IR_REC_STATE_STOP) ? true : false;
 }
 
 /**
@@ -411,10 +493,25 @@ bool IRrecv::isIdle() {
  * Counting of gap timing is independent of StateForISR and therefore independent of call time of resume().
  */
 void IRrecv::resume() {
+#if defined(ENABLE_IR_SELF_TEST)
+    receiveCorrectionIsApplied = false; // The next frame must be corrected
+#endif
+#if defined(ENABLE_IR_PIPELINE)
+    // Release the frame returned by decode() and copy a frame, which is waiting for a free slot
+    if (sPipelineFrameIsInDecode) {
+        sPipelineFrameIsInDecode = false;
+        IR_STORE_RELEASE(sPipelineFramesReadIndex, (sPipelineFramesReadIndex + 1) % IR_PIPELINE_NUMBER_OF_FRAMES);
+        // The ISR does not touch the raw buffer in state IR_REC_STATE_STOP
+        if (IR_LOAD_ACQUIRE(irparams.StateForISR) == IR_REC_STATE_STOP) {
+            copyFrameToPipeline();
+        }
+    }
+#else
     // This check allows to call resume at arbitrary places or more than once
-    if (irparams.StateForISR == IR_REC_STATE_STOP) {
-        irparams.StateForISR = IR_REC_STATE_IDLE;
+    if (IR_LOAD_ACQUIRE(irparams.StateForISR) == IR_REC_STATE_STOP) {
+        IR_STORE_RELEASE(irparams.StateForISR, IR_REC_STATE_IDLE); // pass raw buffer back to ISR
     }
+#endif
 }
 
 /**
@@ -423,7 +520,7 @@ void IRrecv::resume() {
  */
 void IRrecv::initDecodedIRData() {
 
-    if (irparams.OverflowFlag) {
+    if (decodedIRData.rawDataPtr->OverflowFlag) {
         decodedIRData.flags = IRDATA_FLAGS_WAS_OVERFLOW;
 #if defined(LOCAL_DEBUG)
         Serial.print(F("Overflow happened, try to increase the \"RAW_BUFFER_LENGTH\" value of "));
@@ -450,22 +547,80 @@ void IRrecv::initDecodedIRData() {
  * Returns true if IR receiver data is available.
  */
 bool IRrecv::available() {
-    return (irparams.StateForISR == IR_REC_STATE_STOP);
+#if defined(ENABLE_IR_RESULT_FIFO)
+    return (sResultFifoReadIndex != IR_LOAD_ACQUIRE(sResultFifoWriteIndex));
+#else
+#  if defined(USE_NON_DEMODULATING_RECEIVER)
+    checkForEndOfCarrierFrame();
+#  endif
+    return (IR_LOAD_ACQUIRE(irparams.StateForISR) == IR_REC_STATE_STOP);
+#endif
 }
 
+#if defined(ENABLE_IR_RESULT_FIFO)
 /**
- * If IR receiver data is available, returns pointer to IrReceiver.decodedIRData, else NULL.
+ * Decodes the received frame, stores the result in the result FIFO and restarts the receiver.
+ * Has the signature of a receive complete callback, so it can be registered by IrReceiver.registerReceiveCompleteCallback(decodeToResultFifo),
+ * to decode in the ISR context. Or call it from any other context e.g. a timer, a task or the loop.
+ * Decoding in ISR context is not possible for ESP32 and ESP8266, since decoders are not located in IRAM.
+ * If the FIFO is full, the result is lost and counted in IrReceiver.numberOfLostResults.
+ */
+void decodeToResultFifo() {
+    if (!IrReceiver.decode()) {
+        return;
+    }
+    uint8_t tWriteIndex = sResultFifoWriteIndex;
+    uint8_t tNextWriteIndex = (tWriteIndex + 1) % IR_RESULT_FIFO_SIZE;
+    if (tNextWriteIndex == IR_LOAD_ACQUIRE(sResultFifoReadIndex)) {
+        IrReceiver.numberOfLostResults++;
+    } else {
+        IRResultFifoEntry *tEntry = &sResultFifo[tWriteIndex];
+        tEntry->protocol = IrReceiver.decodedIRData.protocol;
+        tEntry->address = IrReceiver.decodedIRData.address;
+        tEntry->command = IrReceiver.decodedIRData.command;
+        tEntry->extra = IrReceiver.decodedIRData.extra;
+        tEntry->decodedRawData = IrReceiver.decodedIRData.decodedRawData;
+        tEntry->numberOfBits = IrReceiver.decodedIRData.numberOfBits;
+        tEntry->flags = IrReceiver.decodedIRData.flags;
+        IR_STORE_RELEASE(sResultFifoWriteIndex, tNextWriteIndex); // Publish entry only after it is completely written
+    }
+    IrReceiver.resume();
+}
+
+/**
+ * Returns the oldest result of the result FIFO or NULL if FIFO is empty.
+ * The returned data is valid until the next call of read(). No resume() is required.
+ * Raw data is not available, since the raw buffer is already reused for the next frame.
  */
 IRData* IRrecv::read() {
-    if (irparams.StateForISR != IR_REC_STATE_STOP) {
+    uint8_t tReadIndex = sResultFifoReadIndex;
+    if (tReadIndex == IR_LOAD_ACQUIRE(sResultFifoWriteIndex)) {
         return NULL;
     }
+    IRResultFifoEntry *tEntry = &sResultFifo[tReadIndex];
+    sResultFifoReadData.protocol = tEntry->protocol;
+    sResultFifoReadData.address = tEntry->address;
+    sResultFifoReadData.command = tEntry->command;
+    sResultFifoReadData.extra = tEntry->extra;
+    sResultFifoReadData.decodedRawData = tEntry->decodedRawData;
+    sResultFifoReadData.numberOfBits = tEntry->numberOfBits;
+    sResultFifoReadData.flags = tEntry->flags;
+    sResultFifoReadData.rawDataPtr = &irparams;
+    IR_STORE_RELEASE(sResultFifoReadIndex, (tReadIndex + 1) % IR_RESULT_FIFO_SIZE); // Entry is copied, release it
+    return &sResultFifoReadData;
+}
+#else
+/**
+ * If IR receiver data is available, returns pointer to IrReceiver.decodedIRData, else NULL.
+ */
+IRData* IRrecv::read() {
     if (decode()) {
         return &decodedIRData;
     } else {
         return NULL;
     }
 }
+#endif
 
 /**
  * The main decode function, attempts to decode the recently receive IR signal.
@@ -474,10 +629,21 @@ IRData* IRrecv::read() {
  * @return false if no IR receiver data available, true if data available.
  */
 bool IRrecv::decode() {
-   
-	if (irparams.StateForISR != IR_REC_STATE_STOP) {
+#if defined(USE_NON_DEMODULATING_RECEIVER)
+    checkForEndOfCarrierFrame();
+#endif
+
+#if defined(ENABLE_IR_PIPELINE)
+    if (sPipelineFramesReadIndex == IR_LOAD_ACQUIRE(sPipelineFramesWriteIndex)) {
+        return false;
+    }
+    decodedIRData.rawDataPtr = &sPipelineFrames[sPipelineFramesReadIndex];
+    sPipelineFrameIsInDecode = true;
+#else
+	if (IR_LOAD_ACQUIRE(irparams.StateForISR) != IR_REC_STATE_STOP) {
         return false;
     }
+#endif
 
     initDecodedIRData(); // sets IRDATA_FLAGS_WAS_OVERFLOW
 
@@ -489,6 +655,24 @@ bool IRrecv::decode() {
         return true;
     }
 
+#if defined(ENABLE_IR_SELF_TEST)
+    applyReceiveCorrection();
+#endif
+
+#if defined(ENABLE_ADDRESS_FILTER)
+    if (isFilteredByAddress()) {
+        resume(); // drop frame without waking up the application
+        return false;
+    }
+#endif
+
+#if defined(ENABLE_USER_DECODERS)
+    IR_TRACE_PRINTLN(F("Attempting user decoders with high priority"));
+    if (decodeWithUserDecoders(0, IR_DECODER_PRIORITY_BUILTIN - 1)) {
+        return true;
+    }
+#endif
+
 #if defined(DECODE_CDTV)
     IR_TRACE_PRINTLN(F("Attempting Commodore CDTV decode"));
     if (decodeCDTV()) {
@@ -612,6 +796,20 @@ bool IRrecv::decode() {
 #endif
 
 
+#if defined(DECODE_DESCRIPTOR)
+    IR_TRACE_PRINTLN(F("Attempting descriptor decode"));
+    if (decodeDescriptors()) {
+        return true;
+    }
+#endif
+
+#if defined(ENABLE_USER_DECODERS)
+    IR_TRACE_PRINTLN(F("Attempting user decoders with low priority"));
+    if (decodeWithUserDecoders(IR_DECODER_PRIORITY_BUILTIN, UINT8_MAX)) {
+        return true;
+    }
+#endif
+
     /*
      * Try the universal decoder for pulse distance protocols
      */
@@ -641,6 +839,90 @@ bool IRrecv::decode() {
     return true;
 }
 
+#if defined(ENABLE_USER_DECODERS)
+/**********************************************************************************************************************
+ * User decoder registration
+ **********************************************************************************************************************/
+struct IRUserDecoderStruct {
+    IRUserDecoderFunctionPointer DecoderFunction;
+    uint8_t Priority;
+    IRTickWindow HeaderMarkTicks; ///< Only frames with a header mark in this window are passed to the decoder. MaxTicks is 0 for no filtering.
+};
+IRUserDecoderStruct sUserDecoders[IR_NUMBER_OF_USER_DECODERS]; // Sorted by priority
+uint8_t sNumberOfUserDecoders;
+
+/**
+ * Registers a user decoder, which is called by decode() according to its priority.
+ * If a decoder with a priority below IR_DECODER_PRIORITY_BUILTIN returns true, the built-in decoders are skipped for this frame.
+ * Decoders with the same priority are called in the order of registration.
+ * @param aPriority         0 is called first. Priorities >= IR_DECODER_PRIORITY_BUILTIN are called after the built-in decoders.
+ * @param aHeaderMarkMicros If not 0, the decoder is only called if the first mark matches this value,
+ *                          which avoids calling the decoder for frames of other protocols.
+ * @return false if IR_NUMBER_OF_USER_DECODERS decoders are already registered.
+ */
+bool IRrecv::registerDecoder(IRUserDecoderFunctionPointer aDecoderFunction, uint8_t aPriority, uint16_t aHeaderMarkMicros) {
+    if (sNumberOfUserDecoders >= IR_NUMBER_OF_USER_DECODERS) {
+        return false;
+    }
+    // Insert sorted by priority, so decodeWithUserDecoders() can stop at the first decoder with a higher priority
+    uint_fast8_t i = sNumberOfUserDecoders;
+    while (i > 0 && sUserDecoders[i - 1].Priority > aPriority) {
+        sUserDecoders[i] = sUserDecoders[i - 1];
+        i--;
+    }
+    sUserDecoders[i].DecoderFunction = aDecoderFunction;
+    sUserDecoders[i].Priority = aPriority;
+    if (aHeaderMarkMicros == 0) {
+        sUserDecoders[i].HeaderMarkTicks.MinTicks = 0;
+        sUserDecoders[i].HeaderMarkTicks.MaxTicks = 0;
+    } else {
+        sUserDecoders[i].HeaderMarkTicks.MinTicks = TICKS_LOW(aHeaderMarkMicros + MARK_EXCESS_MICROS);
+        sUserDecoders[i].HeaderMarkTicks.MaxTicks = TICKS_HIGH(aHeaderMarkMicros + MARK_EXCESS_MICROS);
+    }
+    sNumberOfUserDecoders++;
+    return true;
+}
+
+/**
+ * @return false if decoder was not registered.
+ */
+bool IRrecv::unregisterDecoder(IRUserDecoderFunctionPointer aDecoderFunction) {
+    for (uint_fast8_t i = 0; i < sNumberOfUserDecoders; i++) {
+        if (sUserDecoders[i].DecoderFunction == aDecoderFunction) {
+            sNumberOfUserDecoders--;
+            for (; i < sNumberOfUserDecoders; i++) {
+                sUserDecoders[i] = sUserDecoders[i + 1];
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Calls all registered user decoders with aMinimumPriority <= priority <= aMaximumPriority, until one returns true.
+ */
+bool IRrecv::decodeWithUserDecoders(uint8_t aMinimumPriority, uint8_t aMaximumPriority) {
+    uint16_t tHeaderMarkTicks = decodedIRData.rawDataPtr->rawbuf[1];
+    for (uint_fast8_t i = 0; i < sNumberOfUserDecoders; i++) {
+        IRUserDecoderStruct *tUserDecoder = &sUserDecoders[i];
+        if (tUserDecoder->Priority > aMaximumPriority) {
+            break;
+        }
+        if (tUserDecoder->Priority < aMinimumPriority
+                || (tUserDecoder->HeaderMarkTicks.MaxTicks != 0
+                        && (tHeaderMarkTicks < tUserDecoder->HeaderMarkTicks.MinTicks
+                                || tHeaderMarkTicks > tUserDecoder->HeaderMarkTicks.MaxTicks))) {
+            continue;
+        }
+        if (tUserDecoder->DecoderFunction(&decodedIRData)) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif // defined(ENABLE_USER_DECODERS)
+
 /**********************************************************************************************************************
  * Common decode functions
  **********************************************************************************************************************/
@@ -677,6 +959,19 @@ bool IRrecv::decodePulseDistanceWidthData(uint_fast8_t aNumberOfBits, uint_fast8
     IRRawDataType tDecodedData = 0; // For MSB first tDecodedData is shifted left each loop
     IRRawDataType tMask = 1UL; // Mask is only used for LSB first
 
+    /*
+     * Compute the tick window for a one once, instead of computing it by matchSpace() or matchMark() for each bit.
+     * This saves 2 long multiplications and divisions per bit, the decisions are the same.
+     */
+    uint16_t tOneMatchValueMicros;
+    if (isPulseDistanceProtocol) {
+        tOneMatchValueMicros = aOneSpaceMicros - MARK_EXCESS_MICROS; // compensate for spaces shortened by demodulator hardware
+    } else {
+        tOneMatchValueMicros = aOneMarkMicros + MARK_EXCESS_MICROS; // compensate for marks exceeded by demodulator hardware
+    }
+    uint16_t tOneTicksLow = TICKS_LOW(tOneMatchValueMicros);
+    uint16_t tOneTicksHigh = TICKS_HIGH(tOneMatchValueMicros);
+
     for (uint_fast8_t i = aNumberOfBits; i > 0; i--) {
         // get one mark and space pair
         unsigned int tMarkTicks;
@@ -694,7 +989,7 @@ bool IRrecv::decodePulseDistanceWidthData(uint_fast8_t aNumberOfBits, uint_fast8
             tRawBufPointer++;
 #endif
             tSpaceTicks = *tRawBufPointer++; // maybe buffer overflow for last bit, but we do not evaluate this value :-)
-            tBitValue = matchSpace(tSpaceTicks, aOneSpaceMicros); // Check for variable length space indicating a 1 or 0
+            tBitValue = (tSpaceTicks >= tOneTicksLow && tSpaceTicks <= tOneTicksHigh); // Check for variable length space indicating a 1 or 0
 
 #if defined DECODE_STRICT_CHECKS
             // Check for constant length mark
@@ -717,7 +1012,7 @@ bool IRrecv::decodePulseDistanceWidthData(uint_fast8_t aNumberOfBits, uint_fast8
              * Pulse width here, it is not required to check (constant) space duration and zero mark duration.
              */
             tMarkTicks = *tRawBufPointer++;
-            tBitValue = matchMark(tMarkTicks, aOneMarkMicros); // Check for variable length mark indicating a 1 or 0
+            tBitValue = (tMarkTicks >= tOneTicksLow && tMarkTicks <= tOneTicksHigh); // Check for variable length mark indicating a 1 or 0
 
 #if defined DECODE_STRICT_CHECKS
             tSpaceTicks = *tRawBufPointer++; // maybe buffer overflow for last bit, but we do not evaluate this value :-)
@@ -817,18 +1112,10 @@ bool IRrecv::decodePulseDistanceWidthData(PulseDistanceWidthProtocolConstants *a
             aProtocolConstants->DistanceWidthTimingInfo.ZeroSpaceMicros, aProtocolConstants->Flags);
 }
 
-/*
- * Static variables for the getBiphaselevel function
- */
-uint_fast8_t sBiphaseDecodeRawbuffOffset; // Index into raw timing array
-uint16_t sBiphaseCurrentTimingIntervals; // 1, 2 or 3. Number of aBiphaseTimeUnit intervals of the current rawbuf[sBiphaseDecodeRawbuffOffset] timing.
-uint_fast8_t sBiphaseUsedTimingIntervals;       // Number of already used intervals of sCurrentTimingIntervals.
-uint16_t sBiphaseTimeUnit;
-
 void IRrecv::initBiphaselevel(uint_fast8_t aRCDecodeRawbuffOffset, uint16_t aBiphaseTimeUnit) {
-    sBiphaseDecodeRawbuffOffset = aRCDecodeRawbuffOffset;
-    sBiphaseTimeUnit = aBiphaseTimeUnit;
-    sBiphaseUsedTimingIntervals = 0;
+    biphaseDecodeRawbuffOffset = aRCDecodeRawbuffOffset;
+    biphaseTimeUnit = aBiphaseTimeUnit;
+    biphaseUsedTimingIntervals = 0;
 }
 
 /**
@@ -845,43 +1132,43 @@ void IRrecv::initBiphaselevel(uint_fast8_t aRCDecodeRawbuffOffset, uint16_t aBip
  *                1   0   0   0   1   1   0   1   0   1   1  - Space
  * A mark to space at a significant clock edge results in a 1
  * A space to mark at a significant clock edge results in a 0 (for RC6)
- * Returns current level [MARK or SPACE] or -1 for error (measured time interval is not a multiple of sBiphaseTimeUnit).
+ * Returns current level [MARK or SPACE] or -1 for error (measured time interval is not a multiple of biphaseTimeUnit).
  */
 uint_fast8_t IRrecv::getBiphaselevel() {
     uint_fast8_t tLevelOfCurrentInterval; // 0 (SPACE) or 1 (MARK)
 
-    if (sBiphaseDecodeRawbuffOffset >= decodedIRData.rawDataPtr->rawlen) {
+    if (biphaseDecodeRawbuffOffset >= decodedIRData.rawDataPtr->rawlen) {
         return SPACE;  // After end of recorded buffer, assume space.
     }
 
-    tLevelOfCurrentInterval = (sBiphaseDecodeRawbuffOffset) & 1; // on odd rawbuf offsets we have mark timings
+    tLevelOfCurrentInterval = (biphaseDecodeRawbuffOffset) & 1; // on odd rawbuf offsets we have mark timings
 
     /*
-     * Setup data if sUsedTimingIntervals is 0
+     * Setup data if biphaseUsedTimingIntervals is 0
      */
-    if (sBiphaseUsedTimingIntervals == 0) {
-        uint16_t tCurrentTimingWith = decodedIRData.rawDataPtr->rawbuf[sBiphaseDecodeRawbuffOffset];
+    if (biphaseUsedTimingIntervals == 0) {
+        uint16_t tCurrentTimingWith = decodedIRData.rawDataPtr->rawbuf[biphaseDecodeRawbuffOffset];
         uint16_t tMarkExcessCorrection = (tLevelOfCurrentInterval == MARK) ? MARK_EXCESS_MICROS : -MARK_EXCESS_MICROS;
 
-        if (matchTicks(tCurrentTimingWith, sBiphaseTimeUnit + tMarkExcessCorrection)) {
-            sBiphaseCurrentTimingIntervals = 1;
-        } else if (matchTicks(tCurrentTimingWith, (2 * sBiphaseTimeUnit) + tMarkExcessCorrection)) {
-            sBiphaseCurrentTimingIntervals = 2;
-        } else if (matchTicks(tCurrentTimingWith, (3 * sBiphaseTimeUnit) + tMarkExcessCorrection)) {
-            sBiphaseCurrentTimingIntervals = 3;
+        if (matchTicks(tCurrentTimingWith, biphaseTimeUnit + tMarkExcessCorrection)) {
+            biphaseCurrentTimingIntervals = 1;
+        } else if (matchTicks(tCurrentTimingWith, (2 * biphaseTimeUnit) + tMarkExcessCorrection)) {
+            biphaseCurrentTimingIntervals = 2;
+        } else if (matchTicks(tCurrentTimingWith, (3 * biphaseTimeUnit) + tMarkExcessCorrection)) {
+            biphaseCurrentTimingIntervals = 3;
         } else {
             return -1;
         }
     }
 
 // We use another interval from tCurrentTimingIntervals
-    sBiphaseUsedTimingIntervals++;
+    biphaseUsedTimingIntervals++;
 
 // keep track of current timing offset
-    if (sBiphaseUsedTimingIntervals >= sBiphaseCurrentTimingIntervals) {
+    if (biphaseUsedTimingIntervals >= biphaseCurrentTimingIntervals) {
         // we have used all intervals of current timing, switch to next timing value
-        sBiphaseUsedTimingIntervals = 0;
-        sBiphaseDecodeRawbuffOffset++;
+        biphaseUsedTimingIntervals = 0;
+        biphaseDecodeRawbuffOffset++;
     }
 
     IR_TRACE_PRINTLN(tLevelOfCurrentInterval);
@@ -1210,6 +1497,12 @@ void printActiveIRProtocols(Print *aSerial) {
 #if defined(DECODE_RC5_CDI)
     aSerial->print(F("RC5 CDI, "));
 #endif
+#if defined(DECODE_DESCRIPTOR)
+    aSerial->print(F("Descriptors, "));
+#endif
+#if defined(ENABLE_USER_DECODERS)
+    aSerial->print(F("User decoders, "));
+#endif
 #if defined(DECODE_DISTANCE_WIDTH)
     aSerial->print(F("Universal Pulse Distance Width, "));
 #endif
@@ -1580,6 +1873,13 @@ void IRrecv::compensateAndPrintIRResultAsCArray(Print *aSerial, bool aOutputMicr
 // Comment
     aSerial->print(F("  // "));
     printIRResultShort(aSerial);
+#if defined(USE_NON_DEMODULATING_RECEIVER)
+    aSerial->print(F("// Measured carrier frequency for sendRaw() is "));
+    aSerial->print(getCarrierFrequencyKHz());
+    aSerial->print(F(" kHz, duty cycle "));
+    aSerial->print(getCarrierDutyCyclePercent());
+    aSerial->println(F(" %"));
+#endif
 
 // Newline
     aSerial->println("");
@@ -1617,6 +1917,139 @@ void IRrecv::compensateAndStoreIRResultInArray(uint8_t *aArrayPtr) {
     }
 }
 
+/*
+ * Returns the received duration at aIndex of rawbuf, compensated by MARK_EXCESS_MICROS.
+ */
+static uint16_t getCompensatedDurationMicros(IRData *aIRData, uint_fast16_t aIndex) {
+    int32_t tDuration = aIRData->rawDataPtr->rawbuf[aIndex] * MICROS_PER_TICK;
+    if (aIndex & 1) {
+        // Mark
+        tDuration -= MARK_EXCESS_MICROS;
+    } else {
+        tDuration += MARK_EXCESS_MICROS;
+    }
+    return (tDuration < 0) ? 0 : tDuration;
+}
+
+/**
+ * Dump out the IrReceiver.decodedIRData.rawDataPtr->rawbuf[] as compressed C array to be used for sendRawCompressed_P().
+ * Durations differing less than MICROS_PER_TICK + 1/16 of their value are merged to one symbol with their average duration.
+ * The format is described at IRsend::sendRawCompressed_P().
+ * A comment with the compression ratio relative to the uint16_t and uint8_t arrays for sendRaw_P() is appended.
+ *
+ * @param aSerial The Print object on which to write, for Arduino you can use &Serial.
+ */
+void IRrecv::compensateAndPrintIRResultAsCompressedCArray(Print *aSerial) {
+    uint32_t tSymbolDurationSum[16];
+    uint16_t tSymbolDurationCount[16];
+    uint_fast8_t tNumberOfSymbols = 0;
+    uint_fast16_t tNumberOfIntervals = decodedIRData.rawDataPtr->rawlen - 1;
+
+    /*
+     * Build the symbol dictionary
+     */
+    for (uint_fast16_t i = 1; i <= tNumberOfIntervals; i++) {
+        uint16_t tDuration = getCompensatedDurationMicros(&decodedIRData, i);
+        uint_fast8_t tSymbolIndex;
+        for (tSymbolIndex = 0; tSymbolIndex < tNumberOfSymbols; tSymbolIndex++) {
+            uint16_t tSymbolDuration = tSymbolDurationSum[tSymbolIndex] / tSymbolDurationCount[tSymbolIndex];
+            if (abs((int32_t) tDuration - tSymbolDuration) <= (int32_t) (MICROS_PER_TICK + (tSymbolDuration / 16))) {
+                break;
+            }
+        }
+        if (tSymbolIndex == tNumberOfSymbols) {
+            if (tNumberOfSymbols == 16) {
+                aSerial->println(F("Too many different durations for compressed format, use compensateAndPrintIRResultAsCArray()"));
+                return;
+            }
+            tSymbolDurationSum[tSymbolIndex] = 0;
+            tSymbolDurationCount[tSymbolIndex] = 0;
+            tNumberOfSymbols++;
+        }
+        tSymbolDurationSum[tSymbolIndex] += tDuration;
+        tSymbolDurationCount[tSymbolIndex]++;
+    }
+    uint16_t tSymbolDuration[16];
+    for (uint_fast8_t j = 0; j < tNumberOfSymbols; j++) {
+        tSymbolDuration[j] = tSymbolDurationSum[j] / tSymbolDurationCount[j];
+    }
+
+    uint_fast8_t tBitsPerIndex = 4;
+    if (tNumberOfSymbols <= 2) {
+        tBitsPerIndex = 1;
+    } else if (tNumberOfSymbols <= 4) {
+        tBitsPerIndex = 2;
+    }
+    uint_fast16_t tNumberOfBytes = 3 + (2 * tNumberOfSymbols) + (((tNumberOfIntervals * tBitsPerIndex) + 7) / 8);
+
+// Start declaration
+    aSerial->print(F("const uint8_t rawCompressed["));
+    aSerial->print(tNumberOfBytes);
+    aSerial->print(F("] PROGMEM = {"));
+    aSerial->print(tNumberOfIntervals & 0xFF);
+    aSerial->print(',');
+    aSerial->print(tNumberOfIntervals >> 8);
+    aSerial->print(',');
+    aSerial->print(tNumberOfSymbols);
+    aSerial->print(F(", "));
+    for (uint_fast8_t j = 0; j < tNumberOfSymbols; j++) {
+        aSerial->print(tSymbolDuration[j] & 0xFF);
+        aSerial->print(',');
+        aSerial->print(tSymbolDuration[j] >> 8);
+        aSerial->print(',');
+    }
+    aSerial->print(' ');
+
+    /*
+     * Pack the indexes of the nearest symbols
+     */
+    uint8_t tIndexByte = 0;
+    uint_fast8_t tIndexBitsLeft = 8;
+    for (uint_fast16_t i = 1; i <= tNumberOfIntervals; i++) {
+        uint16_t tDuration = getCompensatedDurationMicros(&decodedIRData, i);
+        uint_fast8_t tBestSymbolIndex = 0;
+        uint16_t tBestDifference = UINT16_MAX;
+        for (uint_fast8_t j = 0; j < tNumberOfSymbols; j++) {
+            uint16_t tDifference = abs((int32_t) tDuration - tSymbolDuration[j]);
+            if (tDifference < tBestDifference) {
+                tBestDifference = tDifference;
+                tBestSymbolIndex = j;
+            }
+        }
+        tIndexBitsLeft -= tBitsPerIndex;
+        tIndexByte |= tBestSymbolIndex << tIndexBitsLeft;
+        if (tIndexBitsLeft == 0 || i == tNumberOfIntervals) {
+            aSerial->print(F("0x"));
+            aSerial->print(tIndexByte, HEX);
+            if (i < tNumberOfIntervals) {
+                aSerial->print(',');
+            }
+            tIndexByte = 0;
+            tIndexBitsLeft = 8;
+        }
+    }
+    aSerial->print(F("};"));
+
+// Comment
+    aSerial->print(F("  // Symbols"));
+    for (uint_fast8_t j = 0; j < tNumberOfSymbols; j++) {
+        aSerial->print(' ');
+        aSerial->print(tSymbolDuration[j]);
+    }
+    aSerial->println(F(" us"));
+    aSerial->print(F("// "));
+    aSerial->print(tNumberOfBytes);
+    aSerial->print(F(" bytes instead of "));
+    aSerial->print(tNumberOfIntervals * 2);
+    aSerial->print(F(" for uint16_t and "));
+    aSerial->print(tNumberOfIntervals);
+    aSerial->print(F(" for uint8_t arrays, compression ratio "));
+    aSerial->print((tNumberOfIntervals * 2) / tNumberOfBytes);
+    aSerial->print('.');
+    aSerial->print((((tNumberOfIntervals * 20) / tNumberOfBytes)) % 10);
+    aSerial->println(F(" for sendRaw_P()"));
+}
+
 /**
  * Print results as C variables to be used for sendXXX()
  * @param aSerial The Print object on which to write, for Arduino you can use &Serial.
@@ -1675,7 +2108,7 @@ const char* IRrecv::getProtocolString() {
  **********************************************************************************************************************/
 bool IRrecv::decode_old(decode_results *aResults) {
 
-    if (irparams.StateForISR != IR_REC_STATE_STOP) {
+    if (IR_LOAD_ACQUIRE(irparams.StateForISR) != IR_REC_STATE_STOP) {
         return false;
     }
 
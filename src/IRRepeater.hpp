@@ -0,0 +1,223 @@
+/**
+ * @file IRRepeater.hpp
+ *
+ * @brief Cut-through repeater, which forwards the received signal to the send pin with a fixed delay.
+ * Each receive timer tick (MICROS_PER_TICK) the input level is written to a delay line and the level
+ * of aDelayTicks ago is output at the send pin, so frames are relayed while they are still arriving.
+ * The carrier is regenerated by the send PWM timer, or the demodulated signal is output if USE_NO_SEND_PWM is defined.
+ * Receiving and decoding continues as usual while the repeater is active.
+ *
+ * An optional filter function gets the length of the first mark of each frame and decides if the frame is forwarded.
+ * For the filter to be effective, the delay must be longer than the longest header mark of interest.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_REPEATER_HPP
+#define _IR_REPEATER_HPP
+
+#if !defined(SEND_PWM_BY_TIMER) && !defined(USE_NO_SEND_PWM)
+#error ENABLE_IR_REPEATER requires SEND_PWM_BY_TIMER or USE_NO_SEND_PWM, since the output is set only once per receive timer tick.
+#endif
+#if defined(USE_NON_DEMODULATING_RECEIVER)
+#error ENABLE_IR_REPEATER requires the receive timer, which is not used for USE_NON_DEMODULATING_RECEIVER.
+#endif
+#if defined(SEND_PWM_BY_TIMER) && defined(__AVR__)
+#error ENABLE_IR_REPEATER and SEND_PWM_BY_TIMER is not possible for AVR, since receive and send use the same timer. Use USE_NO_SEND_PWM and an external modulator.
+#endif
+
+/** \addtogroup Receiving Receiving IR data for multiple protocols
+ * @{
+ */
+
+#define IR_REPEATER_STATE_GAP           0 // Waiting for first mark of a frame
+#define IR_REPEATER_STATE_HEADER_MARK   1 // First mark of a frame, decision of filter is pending
+#define IR_REPEATER_STATE_FORWARD       2
+#define IR_REPEATER_STATE_DROP          3
+
+struct IRRepeaterStruct {
+    bool IsActive;
+    bool OutputIsMark;
+    uint8_t DelayTicks;
+    uint8_t WriteIndex;         // Index of the bit in DelayLine, which is written at the current tick. Wraps around at 256.
+    uint8_t FrameStartIndex;    // Index of the first mark of the current frame, used to suppress a dropped frame in the delay line
+    uint8_t SuppressDelayTicks; // Ticks until output of the dropped part of the delay line starts
+    uint8_t SuppressTicks;      // Number of ticks, for which the output is suppressed, after SuppressDelayTicks are over
+    uint8_t FrameState;
+    uint16_t StateTicks;        // Ticks of current header mark or of current space
+    IRRepeaterFilterFunctionPointer FilterFunction;
+    uint8_t DelayLine[256 / 8]; // One bit per tick, 1 is mark
+};
+IRRepeaterStruct sIRRepeater;
+
+#if defined(IR_SEND_PIN)
+#define REPEATER_SEND_PIN IR_SEND_PIN
+#else
+#define REPEATER_SEND_PIN IrSender.sendPin
+#endif
+
+/*
+ * Like mark() and IRLedOff(), but without feedback LED handling, which is done by the receive ISR
+ */
+#if defined(ESP8266) || defined(ESP32)
+IRAM_ATTR
+#endif
+static void setRepeaterOutput(bool aIsMark) {
+    if (aIsMark) {
+#if defined(SEND_PWM_BY_TIMER)
+        enableSendPWMByTimer();
+#else
+#  if defined(USE_OPEN_DRAIN_OUTPUT_FOR_SEND_PIN) && !defined(OUTPUT_OPEN_DRAIN)
+        pinModeFast(REPEATER_SEND_PIN, OUTPUT); // active state for mimicking open drain
+#  else
+        digitalWriteFast(REPEATER_SEND_PIN, LOW); // Set output to active low.
+#  endif
+#endif
+    } else {
+#if defined(SEND_PWM_BY_TIMER)
+        disableSendPWMByTimer();
+#else
+#  if defined(USE_OPEN_DRAIN_OUTPUT_FOR_SEND_PIN) && !defined(OUTPUT_OPEN_DRAIN)
+        digitalWriteFast(REPEATER_SEND_PIN, LOW); // prepare for all next active states.
+        pinModeFast(REPEATER_SEND_PIN, INPUT); // inactive state for open drain
+#  else
+        digitalWriteFast(REPEATER_SEND_PIN, HIGH); // Set output to inactive high.
+#  endif
+#endif
+    }
+}
+
+/**
+ * Starts forwarding of the received signal to the send pin. The send pin must be set by IrSender.begin() before.
+ * @param aDelayTicks       Delay in MICROS_PER_TICK (50 us) units between receive and send. 1 to 255.
+ * @param aFrequencyKHz     Carrier frequency of the forwarded signal.
+ * @param aFilterFunction   If not NULL, it is called with the ticks of the first mark of each frame and the frame is only forwarded if it returns true.
+ */
+void IRrecv::startRepeater(uint8_t aDelayTicks, uint_fast8_t aFrequencyKHz, IRRepeaterFilterFunctionPointer aFilterFunction) {
+    IrSender.enableIROut(aFrequencyKHz);
+    sIRRepeater.IsActive = false;
+    memset(sIRRepeater.DelayLine, 0, sizeof(sIRRepeater.DelayLine));
+    sIRRepeater.OutputIsMark = false;
+    sIRRepeater.DelayTicks = (aDelayTicks == 0) ? 1 : aDelayTicks;
+    sIRRepeater.FrameState = IR_REPEATER_STATE_GAP;
+    sIRRepeater.SuppressTicks = 0;
+    sIRRepeater.FilterFunction = aFilterFunction;
+    sIRRepeater.IsActive = true; // must be last, since the ISR may be called just now
+}
+
+void IRrecv::stopRepeater() {
+    sIRRepeater.IsActive = false;
+    sIRRepeater.OutputIsMark = false;
+    IrSender.IRLedOff();
+}
+
+/*
+ * Called by the receive timer ISR at each tick
+ */
+#if defined(ESP8266) || defined(ESP32)
+IRAM_ATTR
+#endif
+void handleRepeaterTick(bool aInputIsMark) {
+    if (!sIRRepeater.IsActive) {
+        return;
+    }
+    uint8_t tFrameState = sIRRepeater.FrameState;
+    if (aInputIsMark) {
+        if (tFrameState == IR_REPEATER_STATE_GAP) {
+            sIRRepeater.FrameStartIndex = sIRRepeater.WriteIndex;
+            sIRRepeater.StateTicks = 0;
+            tFrameState = (sIRRepeater.FilterFunction == NULL) ? IR_REPEATER_STATE_FORWARD : IR_REPEATER_STATE_HEADER_MARK;
+        } else if (tFrameState != IR_REPEATER_STATE_HEADER_MARK) {
+            sIRRepeater.StateTicks = 0; // reset space counter
+        }
+        if (tFrameState == IR_REPEATER_STATE_HEADER_MARK && sIRRepeater.StateTicks < UINT16_MAX) {
+            sIRRepeater.StateTicks++;
+        }
+    } else {
+        if (tFrameState == IR_REPEATER_STATE_HEADER_MARK) {
+            // Header mark ended here, ask filter
+            if (sIRRepeater.FilterFunction(sIRRepeater.StateTicks)) {
+                tFrameState = IR_REPEATER_STATE_FORWARD;
+            } else {
+                /*
+                 * Suppress the output of the part of the frame, which is still in the delay line.
+                 * It is read after DelayTicks - tFrameTicks ticks. The part before is already sent.
+                 * A pending suppression of an earlier frame is extended up to the end of this frame, the ticks in between are spaces anyway.
+                 */
+                uint8_t tFrameTicks = sIRRepeater.WriteIndex - sIRRepeater.FrameStartIndex;
+                if (tFrameTicks > sIRRepeater.DelayTicks) {
+                    tFrameTicks = sIRRepeater.DelayTicks;
+                }
+                uint8_t tSuppressDelayTicks = sIRRepeater.DelayTicks - tFrameTicks;
+                if (sIRRepeater.SuppressTicks != 0 && sIRRepeater.SuppressDelayTicks < tSuppressDelayTicks) {
+                    tSuppressDelayTicks = sIRRepeater.SuppressDelayTicks;
+                }
+                sIRRepeater.SuppressDelayTicks = tSuppressDelayTicks;
+                sIRRepeater.SuppressTicks = sIRRepeater.DelayTicks - tSuppressDelayTicks;
+                tFrameState = IR_REPEATER_STATE_DROP;
+            }
+            sIRRepeater.StateTicks = 0;
+        }
+        if (tFrameState != IR_REPEATER_STATE_GAP) {
+            sIRRepeater.StateTicks++;
+            if (sIRRepeater.StateTicks > RECORD_GAP_TICKS) {
+                tFrameState = IR_REPEATER_STATE_GAP;
+            }
+        }
+    }
+    sIRRepeater.FrameState = tFrameState;
+
+    /*
+     * Write input to delay line and output the delayed level
+     */
+    uint8_t tWriteIndex = sIRRepeater.WriteIndex;
+    uint8_t tMask = 1 << (tWriteIndex & 0x07);
+    if (aInputIsMark && tFrameState != IR_REPEATER_STATE_DROP) {
+        sIRRepeater.DelayLine[tWriteIndex / 8] |= tMask;
+    } else {
+        sIRRepeater.DelayLine[tWriteIndex / 8] &= ~tMask;
+    }
+    uint8_t tReadIndex = tWriteIndex - sIRRepeater.DelayTicks;
+    bool tOutputIsMark = sIRRepeater.DelayLine[tReadIndex / 8] & (1 << (tReadIndex & 0x07));
+    if (sIRRepeater.SuppressTicks != 0) {
+        if (sIRRepeater.SuppressDelayTicks != 0) {
+            sIRRepeater.SuppressDelayTicks--;
+        } else {
+            sIRRepeater.SuppressTicks--;
+            tOutputIsMark = false;
+        }
+    }
+    if (tOutputIsMark != sIRRepeater.OutputIsMark) {
+        sIRRepeater.OutputIsMark = tOutputIsMark;
+        setRepeaterOutput(tOutputIsMark);
+    }
+    sIRRepeater.WriteIndex = tWriteIndex + 1;
+}
+
+#undef REPEATER_SEND_PIN
+
+/** @}*/
+#endif // _IR_REPEATER_HPP
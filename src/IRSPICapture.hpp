@@ -0,0 +1,283 @@
+/**
+ * @file IRSPICapture.hpp
+ *
+ * @brief Receiving by continuous sampling of the receiver output with a fixed, high sample rate instead of the 50 us timer ISR.
+ * feedSampledBits() extracts the runs of equal bits of a stream of 16 bit sample words and feeds them as durations to feedDuration().
+ * Words without level change are skipped as a whole, so the extraction costs only a few cycles per sample word.
+ * For the RP2040, startSPICapture() clocks the SPI hardware continuously and lets DMA write the bits sampled at MISO into a ring buffer,
+ * which is read by pollSPICapture(). Then the timing does not depend on interrupt latency at all.
+ * For other platforms, e.g. I2S with DMA on ESP32, the words read from the DMA buffers can be fed to feedSampledBits().
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_SPI_CAPTURE_HPP
+#define _IR_SPI_CAPTURE_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Receiving Receiving IR data for multiple protocols
+ * @{
+ */
+
+/*
+ * Data for converting sampled bits to durations
+ */
+struct IRSampledBitsStruct {
+    uint32_t MicrosPerSampleShift8; // Micros per sample * 256
+    uint32_t SamplesForRecordGap; // Runs are fed at least after this number of samples, to signal the end of frame in time
+    uint32_t NumberOfSamples; // Number of samples of the current run
+    bool MarkIsLow; // true for the active low output of a demodulating receiver
+    bool IsHigh; // Level of the current run
+};
+IRSampledBitsStruct sIRSampledBits;
+
+/**
+ * Sets the parameters for feedSampledBits() and resets the conversion.
+ * @param aSampleRateHertz  Bit rate of the sampling, e.g. the SPI clock or the I2S bit clock.
+ * @param aMarkIsLow        true for sampling the active low output of a demodulating receiver module.
+ */
+void IRrecv::setSampledBitsParameters(uint32_t aSampleRateHertz, bool aMarkIsLow) {
+    sIRSampledBits.MicrosPerSampleShift8 = (MICROS_IN_ONE_SECOND * 256UL) / aSampleRateHertz;
+    sIRSampledBits.SamplesForRecordGap = ((RECORD_GAP_MICROS + MICROS_PER_TICK) * 256UL) / sIRSampledBits.MicrosPerSampleShift8;
+    sIRSampledBits.MarkIsLow = aMarkIsLow;
+    sIRSampledBits.IsHigh = aMarkIsLow; // start with space
+    sIRSampledBits.NumberOfSamples = 0;
+}
+
+/*
+ * Feeds the current run and starts a new one
+ */
+static bool feedSampledRun(IRrecv *aReceiver) {
+    uint32_t tMicros = ((sIRSampledBits.NumberOfSamples * sIRSampledBits.MicrosPerSampleShift8) + 128) >> 8;
+    sIRSampledBits.NumberOfSamples = 0;
+    return aReceiver->feedDuration(sIRSampledBits.IsHigh != sIRSampledBits.MarkIsLow, tMicros);
+}
+
+/**
+ * Feeds sample words to the receive state machine. The first sample is the MSB of each word.
+ * Successive runs of the same level are added by feedDuration(), so the stream can be fed in chunks of any size.
+ * The receiver must not be started by begin() or start(), since the ISR uses the same raw buffer.
+ * @return true if a frame is complete and can be decoded by decode(). Call resume() after decoding, else all following marks are ignored.
+ */
+bool IRrecv::feedSampledBits(const uint16_t *aWords, uint16_t aNumberOfWords) {
+    uint16_t tRunWord = sIRSampledBits.IsHigh ? 0xFFFF : 0; // A word without level change
+    for (uint16_t i = 0; i < aNumberOfWords; i++) {
+        uint16_t tWord = aWords[i];
+        if (tWord == tRunWord) {
+            // Fast path for the most frequent case
+            sIRSampledBits.NumberOfSamples += 16;
+        } else {
+            /*
+             * tDiff contains a 1 for each sample, which differs from the level of the current run, starting at the MSB.
+             * The number of leading zeros is the number of samples until the next level change.
+             */
+            uint32_t tDiff = (uint32_t) (tWord ^ tRunWord) << 16;
+            uint_fast8_t tRemainingSamples = 16;
+            while (tDiff != 0) {
+                uint_fast8_t tRunLength = __builtin_clzl(tDiff) - ((sizeof(unsigned long) - sizeof(uint32_t)) * 8); // Correction for 64 bit hosts
+                sIRSampledBits.NumberOfSamples += tRunLength;
+                feedSampledRun(this);
+                sIRSampledBits.IsHigh = !sIRSampledBits.IsHigh;
+                tRemainingSamples -= tRunLength;
+                // The differences to the new level are the inverted differences to the old level, restricted to the remaining samples
+                tDiff = ~(tDiff << tRunLength) & (UINT32_MAX << (32 - tRemainingSamples));
+            }
+            sIRSampledBits.NumberOfSamples += tRemainingSamples;
+            tRunWord = sIRSampledBits.IsHigh ? 0xFFFF : 0;
+        }
+        if (sIRSampledBits.NumberOfSamples >= sIRSampledBits.SamplesForRecordGap) {
+            // Signal end of frame now, not at the next mark, which may come hours later
+            feedSampledRun(this);
+        }
+    }
+    return (irparams.StateForISR == IR_REC_STATE_STOP);
+}
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+
+/*
+ * The DMA ring must be aligned to its size in bytes
+ */
+uint16_t sIRCaptureRingBuffer[IR_CAPTURE_RING_BUFFER_SIZE] __attribute__((aligned(IR_CAPTURE_RING_BUFFER_SIZE * 2)));
+const uint16_t sIRCaptureTransmitWord = 0; // Only sent to generate the SPI clock
+struct IRSPICaptureStruct {
+    spi_inst_t *SPIInstance;
+    int8_t TransmitDMAChannel; // -1 if capture is not running
+    int8_t ReceiveDMAChannel;
+    uint32_t LastTransferCount; // Transfer count of the receive channel at the last poll
+};
+IRSPICaptureStruct sIRSPICapture = { NULL, -1, -1, 0 };
+
+/*
+ * Starts both DMA channels with the maximum transfer count, which lasts 19 hours at 1 MHz
+ */
+static void startSPICaptureDMA() {
+    spi_inst_t *tSPI = sIRSPICapture.SPIInstance;
+    // Discard old samples in the receive FIFO
+    while (spi_is_readable(tSPI)) {
+        (void) spi_get_hw(tSPI)->dr;
+    }
+
+    dma_channel_config tConfig = dma_channel_get_default_config(sIRSPICapture.ReceiveDMAChannel);
+    channel_config_set_transfer_data_size(&tConfig, DMA_SIZE_16);
+    channel_config_set_read_increment(&tConfig, false);
+    channel_config_set_write_increment(&tConfig, true);
+    channel_config_set_ring(&tConfig, true, IR_CAPTURE_RING_BUFFER_SIZE_LOG2 + 1); // Wrap write address, size in bytes
+    channel_config_set_dreq(&tConfig, spi_get_dreq(tSPI, false));
+    dma_channel_configure(sIRSPICapture.ReceiveDMAChannel, &tConfig, sIRCaptureRingBuffer, &spi_get_hw(tSPI)->dr, UINT32_MAX,
+            true);
+
+    tConfig = dma_channel_get_default_config(sIRSPICapture.TransmitDMAChannel);
+    channel_config_set_transfer_data_size(&tConfig, DMA_SIZE_16);
+    channel_config_set_read_increment(&tConfig, false);
+    channel_config_set_write_increment(&tConfig, false);
+    channel_config_set_dreq(&tConfig, spi_get_dreq(tSPI, true));
+    dma_channel_configure(sIRSPICapture.TransmitDMAChannel, &tConfig, &spi_get_hw(tSPI)->dr, &sIRCaptureTransmitWord, UINT32_MAX,
+            true);
+
+    sIRSPICapture.LastTransferCount = UINT32_MAX;
+}
+
+static void stopSPICaptureDMA() {
+    dma_channel_abort(sIRSPICapture.TransmitDMAChannel);
+    dma_channel_abort(sIRSPICapture.ReceiveDMAChannel);
+}
+
+/**
+ * Starts sampling the receiver output at aMISOPin with IR_CAPTURE_SAMPLE_RATE by the SPI hardware and 2 DMA channels.
+ * One DMA channel sends dummy words to clock the SPI, the other writes the received words into a ring buffer.
+ * The SPI clock and chip select are not output, so only aMISOPin is used.
+ * @param aMISOPin  Must be a SPI RX pin, i.e. 0, 4, 16, 20 for SPI0 or 8, 12, 24, 28 for SPI1.
+ * @return false if aMISOPin is no SPI RX pin or no DMA channel is free.
+ */
+bool IRrecv::startSPICapture(uint_fast8_t aMISOPin, bool aMarkIsLow) {
+    if ((aMISOPin & 0x03) != 0 || aMISOPin > 28 || sIRSPICapture.TransmitDMAChannel >= 0) {
+        return false;
+    }
+    int tTransmitDMAChannel = dma_claim_unused_channel(false);
+    int tReceiveDMAChannel = dma_claim_unused_channel(false);
+    if (tTransmitDMAChannel < 0 || tReceiveDMAChannel < 0) {
+        if (tTransmitDMAChannel >= 0) {
+            dma_channel_unclaim(tTransmitDMAChannel);
+        }
+        return false;
+    }
+    sIRSPICapture.TransmitDMAChannel = tTransmitDMAChannel;
+    sIRSPICapture.ReceiveDMAChannel = tReceiveDMAChannel;
+
+    spi_inst_t *tSPI = (aMISOPin & 0x08) ? spi1 : spi0;
+    sIRSPICapture.SPIInstance = tSPI;
+    // The SPI clock is derived from clk_peri, so the sample rate can differ from IR_CAPTURE_SAMPLE_RATE
+    uint32_t tSampleRate = spi_init(tSPI, IR_CAPTURE_SAMPLE_RATE);
+    // With phase 1, chip select stays active between words, so the words are sampled without gap
+    spi_set_format(tSPI, 16, SPI_CPOL_0, SPI_CPHA_1, SPI_MSB_FIRST);
+    gpio_set_function(aMISOPin, GPIO_FUNC_SPI);
+
+    setSampledBitsParameters(tSampleRate, aMarkIsLow);
+    irparams.StateForISR = IR_REC_STATE_IDLE;
+    irparams.TickCounterForISR = 0;
+    startSPICaptureDMA();
+    return true;
+}
+
+void IRrecv::stopSPICapture() {
+    if (sIRSPICapture.TransmitDMAChannel < 0) {
+        return;
+    }
+    stopSPICaptureDMA();
+    spi_deinit(sIRSPICapture.SPIInstance);
+    dma_channel_unclaim(sIRSPICapture.TransmitDMAChannel);
+    dma_channel_unclaim(sIRSPICapture.ReceiveDMAChannel);
+    sIRSPICapture.TransmitDMAChannel = -1;
+}
+
+/**
+ * Feeds all words written by DMA since the last call to feedSampledBits().
+ * Must be called at least every IR_CAPTURE_RING_BUFFER_SIZE * 16 samples, i.e. every 16 ms for the defaults.
+ * If the ring buffer overflowed, the current frame is marked with IRDATA_FLAGS_WAS_OVERFLOW.
+ * @return true if a frame is complete and can be decoded by decode(). Call resume() after decoding.
+ */
+bool IRrecv::pollSPICapture() {
+    if (sIRSPICapture.TransmitDMAChannel < 0) {
+        return false;
+    }
+    uint32_t tTransferCount = dma_channel_hw_addr(sIRSPICapture.ReceiveDMAChannel)->transfer_count;
+    uint32_t tNumberOfNewWords = sIRSPICapture.LastTransferCount - tTransferCount;
+    // The index of the next word to read. Words are written since start, which was with UINT32_MAX
+    uint16_t tReadIndex = (UINT32_MAX - sIRSPICapture.LastTransferCount) & (IR_CAPTURE_RING_BUFFER_SIZE - 1);
+    sIRSPICapture.LastTransferCount = tTransferCount;
+
+    if (tNumberOfNewWords > IR_CAPTURE_RING_BUFFER_SIZE) {
+        /*
+         * Samples are lost, so end the current frame like the ISR does for a full raw buffer
+         */
+#if defined(LOCAL_DEBUG)
+        Serial.print(F("Capture overrun by "));
+        Serial.print(tNumberOfNewWords - IR_CAPTURE_RING_BUFFER_SIZE);
+        Serial.println(F(" words"));
+#endif
+        if (irparams.StateForISR == IR_REC_STATE_MARK || irparams.StateForISR == IR_REC_STATE_SPACE) {
+            irparams.OverflowFlag = true;
+            irparams.TickCounterForISR = 0;
+            irparams.StateForISR = IR_REC_STATE_STOP;
+            handleEndOfFedFrame();
+        }
+        // Continue with the oldest words, which are not yet overwritten
+        tReadIndex = (tReadIndex + tNumberOfNewWords) & (IR_CAPTURE_RING_BUFFER_SIZE - 1);
+        tNumberOfNewWords = IR_CAPTURE_RING_BUFFER_SIZE;
+        sIRSampledBits.NumberOfSamples = 0;
+    }
+
+    uint16_t tNumberOfWordsUntilWrap = IR_CAPTURE_RING_BUFFER_SIZE - tReadIndex;
+    if (tNumberOfNewWords > tNumberOfWordsUntilWrap) {
+        feedSampledBits(&sIRCaptureRingBuffer[tReadIndex], tNumberOfWordsUntilWrap);
+        feedSampledBits(sIRCaptureRingBuffer, tNumberOfNewWords - tNumberOfWordsUntilWrap);
+    } else {
+        feedSampledBits(&sIRCaptureRingBuffer[tReadIndex], tNumberOfNewWords);
+    }
+
+    if (tTransferCount < (UINT32_MAX / 2) && irparams.StateForISR == IR_REC_STATE_IDLE) {
+        // Restart before the transfer count ends, while no frame is received. This loses only a few samples of the gap.
+        stopSPICaptureDMA();
+        startSPICaptureDMA();
+    }
+    return (irparams.StateForISR == IR_REC_STATE_STOP);
+}
+#endif // defined(ARDUINO_ARCH_RP2040)
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_SPI_CAPTURE_HPP
@@ -0,0 +1,90 @@
+/**
+ * @file IRSPICarrierPattern.hpp
+ *
+ * @brief Computation of the carrier bit pattern for SEND_PWM_BY_SPI, see IRSendSPI.hpp.
+ * It does not access any hardware, so it can be checked on every board and on the host, see examples/SPICarrierPatternTest.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_SPI_CARRIER_PATTERN_HPP
+#define _IR_SPI_CARRIER_PATTERN_HPP
+
+#include <stdint.h>
+
+/** \addtogroup Sending Sending IR data for multiple protocols
+ * @{
+ */
+/**
+ * Fills aPattern with the carrier bits, MSB first, starting with the on period.
+ * If possible, the pattern contains an integer number of carrier periods, so it can be repeated without phase jump.
+ * Then the number of bits of the single periods vary by 1 if aBitRate is no multiple of aFrequencyHz, but the mean frequency is exact.
+ * If not possible, the complete aPatternSize is used and the frequency is rounded to an integer number of periods in it.
+ * This function does not access any hardware.
+ * @return Number of bytes of the pattern.
+ */
+uint16_t computeSPICarrierPattern(uint8_t *aPattern, uint16_t aPatternSize, uint32_t aBitRate, uint32_t aFrequencyHz,
+        uint_fast8_t aDutyCyclePercent) {
+    /*
+     * Find the smallest number of bytes containing an integer number of periods
+     */
+    uint16_t tNumberOfBytes = aPatternSize;
+    for (uint16_t i = 1; i <= aPatternSize; i++) {
+        if (((uint32_t) i * 8 * aFrequencyHz) % aBitRate == 0) {
+            tNumberOfBytes = i;
+            break;
+        }
+    }
+    uint32_t tNumberOfBits = (uint32_t) tNumberOfBytes * 8;
+    uint32_t tNumberOfPeriods = ((tNumberOfBits * aFrequencyHz) + (aBitRate / 2)) / aBitRate;
+    if (tNumberOfPeriods == 0) {
+        tNumberOfPeriods = 1;
+    }
+
+    /*
+     * The phase of bit i is (i * tNumberOfPeriods) mod tNumberOfBits, and the bit is on, if the phase is in the first aDutyCyclePercent of the period
+     */
+    uint32_t tOnPhaseLimit = (tNumberOfBits * aDutyCyclePercent) / 100;
+    uint32_t tPhase = 0;
+    for (uint16_t i = 0; i < tNumberOfBytes; i++) {
+        uint8_t tByte = 0;
+        for (uint_fast8_t j = 0; j < 8; j++) {
+            tByte <<= 1;
+            if (tPhase < tOnPhaseLimit) {
+                tByte |= 1;
+            }
+            tPhase += tNumberOfPeriods;
+            if (tPhase >= tNumberOfBits) {
+                tPhase -= tNumberOfBits;
+            }
+        }
+        aPattern[i] = tByte;
+    }
+    return tNumberOfBytes;
+}
+
+/** @}*/
+#endif // _IR_SPI_CARRIER_PATTERN_HPP
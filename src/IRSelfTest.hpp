@@ -0,0 +1,334 @@
+/**
+ * @file IRSelfTest.hpp
+ *
+ * @brief Loopback self test of sending and receiving, with the send LED optically or electrically coupled to the receiver.
+ * Each enabled protocol is sent several times and the decoded protocol, address and command are checked.
+ * The intervals recorded by the send recorder are compared with the received ones to get the mark excess and space shortening of the receiver,
+ * which can then be applied as correction for all following decodes.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_SELF_TEST_HPP
+#define _IR_SELF_TEST_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+#if defined(SEND_PWM_BY_TIMER) && !defined(SEND_PWM_DOES_NOT_USE_RECEIVE_TIMER)
+#error ENABLE_IR_SELF_TEST requires receiving while sending, which is not possible if SEND_PWM_BY_TIMER uses the receive timer
+#endif
+
+/** \addtogroup Receiving Receiving IR data for multiple protocols
+ * @{
+ */
+
+#define IR_SELF_TEST_ADDRESS            0x0B // Fits for the 5 bit address of Sony and RC5
+#define IR_SELF_TEST_COMMAND            0x12
+#define IR_SELF_TEST_TIMEOUT_MILLIS     (RECORD_GAP_MICROS / 1000 + 20)
+#define IR_SELF_TEST_DELAY_BETWEEN_FRAMES_MILLIS   150 // Greater than the maximum repeat distance of all protocols, to avoid detection as repeat
+
+/*
+ * All protocols, which are sent by write() and decoded with the same protocol, address and command.
+ * Protocols, which are only distinguished by their repeats, like NEC2 and SAMSUNG_LG, are omitted.
+ */
+static const decode_type_t sSelfTestProtocols[] = {
+#if defined(DECODE_NEC)
+        NEC, APPLE,
+#endif
+#if defined(DECODE_ONKYO)
+        ONKYO,
+#endif
+#if defined(DECODE_PANASONIC) || defined(DECODE_KASEIKYO)
+        PANASONIC, KASEIKYO_DENON, KASEIKYO_SHARP, KASEIKYO_JVC, KASEIKYO_MITSUBISHI,
+#endif
+#if defined(DECODE_DENON)
+        DENON, SHARP,
+#endif
+#if defined(DECODE_SONY)
+        SONY,
+#endif
+#if defined(DECODE_RC5)
+        RC5,
+#endif
+#if defined(DECODE_RC6)
+        RC6,
+#endif
+#if defined(DECODE_LG)
+        LG,
+#endif
+#if defined(DECODE_JVC)
+        JVC,
+#endif
+#if defined(DECODE_SAMSUNG)
+        SAMSUNG, SAMSUNG48,
+#endif
+#if defined(DECODE_BOSEWAVE)
+        BOSEWAVE,
+#endif
+#if defined(DECODE_FAST)
+        FAST,
+#endif
+        UNKNOWN // Terminator, which also avoids an empty array
+        };
+#define IR_SELF_TEST_NUMBER_OF_PROTOCOLS ((sizeof(sSelfTestProtocols) / sizeof(decode_type_t)) - 1)
+
+struct IRSelfTestResultStruct {
+    decode_type_t Protocol;
+    uint8_t NumberOfSentFrames;
+    uint8_t NumberOfDecodedFrames; ///< Frames with matching protocol, address and command
+    int16_t MarkExcessMicros; ///< Mean of received minus sent mark durations
+    int16_t SpaceShorteningMicros; ///< Mean of sent minus received space durations
+};
+
+/**
+ * Report of runIRSelfTest(). The timing values are measured without correction.
+ */
+struct IRSelfTestReportStruct {
+    IRSelfTestResultStruct Results[IR_SELF_TEST_NUMBER_OF_PROTOCOLS];
+    uint8_t NumberOfFailedProtocols; ///< Number of protocols, where not all sent frames were decoded
+    int16_t MarkExcessMicros; ///< Mean over all protocols
+    int16_t SpaceShorteningMicros; ///< Mean over all protocols
+};
+
+/*
+ * Returns aMicros / MICROS_PER_TICK rounded to nearest for positive and negative values
+ */
+static int8_t getRoundedTicks(int16_t aMicros) {
+    if (aMicros >= 0) {
+        return (aMicros + (MICROS_PER_TICK / 2)) / MICROS_PER_TICK;
+    }
+    return -((-aMicros + (MICROS_PER_TICK / 2)) / MICROS_PER_TICK);
+}
+
+/**
+ * Sets the correction applied to the raw data of all following frames before decoding.
+ * Only the difference to the compiled MARK_EXCESS_MICROS is applied, and only in multiples of MICROS_PER_TICK.
+ * The raw data printed or stored after decode() are the corrected values.
+ * @param aMarkExcessMicros         Measured mark excess of the receiver, e.g. IRSelfTestReportStruct.MarkExcessMicros.
+ * @param aSpaceShorteningMicros    Measured space shortening of the receiver.
+ */
+void IRrecv::setReceiveCorrection(int16_t aMarkExcessMicros, int16_t aSpaceShorteningMicros) {
+    markCorrectionTicks = getRoundedTicks(aMarkExcessMicros - MARK_EXCESS_MICROS);
+    spaceCorrectionTicks = getRoundedTicks(aSpaceShorteningMicros - MARK_EXCESS_MICROS);
+}
+
+/*
+ * Called by decode() before the decoders are run.
+ * Marks are shortened by markCorrectionTicks and spaces are extended by spaceCorrectionTicks. The leading gap is not changed.
+ * If decode() is called again for the same frame, the frame is not corrected again.
+ */
+void IRrecv::applyReceiveCorrection() {
+    if (receiveCorrectionIsApplied) {
+        return;
+    }
+    receiveCorrectionIsApplied = true;
+    if (markCorrectionTicks == 0 && spaceCorrectionTicks == 0) {
+        return;
+    }
+    irparams_struct *tRawDataPtr = decodedIRData.rawDataPtr;
+    for (uint_fast16_t i = 1; i < tRawDataPtr->rawlen; i++) {
+        int16_t tTicks = tRawDataPtr->rawbuf[i];
+        if (i & 1) {
+            tTicks -= markCorrectionTicks;
+        } else {
+            tTicks += spaceCorrectionTicks;
+        }
+        tRawDataPtr->rawbuf[i] = (tTicks > 0) ? tTicks : 1;
+    }
+}
+
+/*
+ * Compares the received raw data with the intervals recorded while sending.
+ * Consecutive recorded intervals of the same level, e.g. of biphase protocols, are merged like the receiver does.
+ * The measured duration is taken if available, since it contains the timing error of the sender.
+ */
+static void addSelfTestTimingErrors(int32_t *aSumOfMarkExcess, uint16_t *aNumberOfMarks, int32_t *aSumOfSpaceShortening,
+        uint16_t *aNumberOfSpaces) {
+    irparams_struct *tRawDataPtr = IrReceiver.decodedIRData.rawDataPtr;
+    uint_fast16_t tNumberOfIntervals = sIRSendRecorder.NumberOfIntervals;
+    if (tNumberOfIntervals > IR_SEND_RECORDER_SIZE) {
+        tNumberOfIntervals = IR_SEND_RECORDER_SIZE;
+    }
+    uint_fast16_t tRawIndex = 1;
+    uint_fast16_t i = 0;
+    // Skip leading spaces, e.g. of the start bit of RC5, they are part of the gap for the receiver
+    while (i < tNumberOfIntervals && !(sIRSendRecorder.IsMarkBits[i / 8] & (1 << (i & 7)))) {
+        i++;
+    }
+    while (i < tNumberOfIntervals && tRawIndex < tRawDataPtr->rawlen) {
+        bool tIsMark = sIRSendRecorder.IsMarkBits[i / 8] & (1 << (i & 7));
+        if (tIsMark != ((tRawIndex & 1) != 0)) {
+            return; // not aligned
+        }
+        int32_t tSentMicros = 0;
+        while (i < tNumberOfIntervals && tIsMark == ((sIRSendRecorder.IsMarkBits[i / 8] & (1 << (i & 7))) != 0)) {
+            uint16_t tMicros = sIRSendRecorder.MeasuredMicros[i];
+            tSentMicros += (tMicros != 0) ? tMicros : sIRSendRecorder.RequestedMicros[i];
+            i++;
+        }
+        int32_t tError = ((int32_t) tRawDataPtr->rawbuf[tRawIndex] * MICROS_PER_TICK) - tSentMicros;
+        if (tIsMark) {
+            *aSumOfMarkExcess += tError;
+            (*aNumberOfMarks)++;
+        } else {
+            *aSumOfSpaceShortening -= tError;
+            (*aNumberOfSpaces)++;
+        }
+        tRawIndex++;
+    }
+}
+
+/**
+ * Sends each enabled protocol aNumberOfFramesPerProtocol times with different commands and checks the decoded results.
+ * The receiver must be started with IrReceiver.begin() and the sender with IrSender.begin() before,
+ * and the send LED must be coupled to the receiver, e.g. by facing it or by a resistor from the send pin to the receive pin with USE_NO_SEND_PWM.
+ * Pending received frames are discarded.
+ * @param aReport                   Filled with the results of each protocol.
+ * @param aNumberOfFramesPerProtocol Number of frames sent for each protocol.
+ * @param aApplyCorrection          If true, the measured mark excess and space shortening are applied by setReceiveCorrection().
+ * @return true if all sent frames were decoded correctly.
+ */
+bool runIRSelfTest(IRSelfTestReportStruct *aReport, uint8_t aNumberOfFramesPerProtocol, bool aApplyCorrection) {
+    IrReceiver.markCorrectionTicks = 0; // measure uncorrected
+    IrReceiver.spaceCorrectionTicks = 0;
+    while (IrReceiver.decode()) {
+        IrReceiver.resume();
+    }
+
+    int32_t tSumOfAllMarkExcess = 0;
+    int32_t tSumOfAllSpaceShortening = 0;
+    uint16_t tNumberOfAllMarks = 0;
+    uint16_t tNumberOfAllSpaces = 0;
+    aReport->NumberOfFailedProtocols = 0;
+
+    for (uint_fast8_t tProtocolIndex = 0; tProtocolIndex < IR_SELF_TEST_NUMBER_OF_PROTOCOLS; tProtocolIndex++) {
+        decode_type_t tProtocol = sSelfTestProtocols[tProtocolIndex];
+        IRSelfTestResultStruct *tResult = &aReport->Results[tProtocolIndex];
+        tResult->Protocol = tProtocol;
+        tResult->NumberOfSentFrames = 0;
+        tResult->NumberOfDecodedFrames = 0;
+        int32_t tSumOfMarkExcess = 0;
+        int32_t tSumOfSpaceShortening = 0;
+        uint16_t tNumberOfMarks = 0;
+        uint16_t tNumberOfSpaces = 0;
+        // BoseWave and FAST have no address
+        uint16_t tAddress = (tProtocol == BOSEWAVE || tProtocol == FAST) ? 0 : IR_SELF_TEST_ADDRESS;
+
+        for (uint_fast8_t tFrame = 0; tFrame < aNumberOfFramesPerProtocol; tFrame++) {
+            uint16_t tCommand = (IR_SELF_TEST_COMMAND + (tFrame * 0x11)) & 0x7F; // vary the bits, but keep the 7 bit command of Sony and RC5
+            delay(IR_SELF_TEST_DELAY_BETWEEN_FRAMES_MILLIS);
+            IrSender.startRecording();
+            IrSender.write(tProtocol, tAddress, tCommand, NO_REPEATS);
+            IrSender.stopRecording();
+            tResult->NumberOfSentFrames++;
+
+            bool tIsReceived = false;
+            uint32_t tStartMillis = millis();
+            while (millis() - tStartMillis <= IR_SELF_TEST_TIMEOUT_MILLIS) {
+                if (IrReceiver.decode()) {
+                    tIsReceived = true;
+                    break;
+                }
+            }
+            if (!tIsReceived) {
+                IR_DEBUG_PRINT(F("Self test: nothing received for "));
+                IR_DEBUG_PRINTLN(getProtocolString(tProtocol));
+                continue;
+            }
+            if (!(IrReceiver.decodedIRData.flags & IRDATA_FLAGS_WAS_OVERFLOW)) {
+                addSelfTestTimingErrors(&tSumOfMarkExcess, &tNumberOfMarks, &tSumOfSpaceShortening, &tNumberOfSpaces);
+            }
+            if (IrReceiver.decodedIRData.protocol == tProtocol && IrReceiver.decodedIRData.address == tAddress
+                    && IrReceiver.decodedIRData.command == tCommand) {
+                tResult->NumberOfDecodedFrames++;
+            }
+#if defined(LOCAL_DEBUG)
+            else {
+                IrReceiver.printIRResultShort(&Serial);
+            }
+#endif
+            IrReceiver.resume();
+        }
+
+        tResult->MarkExcessMicros = (tNumberOfMarks > 0) ? tSumOfMarkExcess / tNumberOfMarks : 0;
+        tResult->SpaceShorteningMicros = (tNumberOfSpaces > 0) ? tSumOfSpaceShortening / tNumberOfSpaces : 0;
+        tSumOfAllMarkExcess += tSumOfMarkExcess;
+        tSumOfAllSpaceShortening += tSumOfSpaceShortening;
+        tNumberOfAllMarks += tNumberOfMarks;
+        tNumberOfAllSpaces += tNumberOfSpaces;
+        if (tResult->NumberOfDecodedFrames < tResult->NumberOfSentFrames) {
+            aReport->NumberOfFailedProtocols++;
+        }
+    }
+
+    aReport->MarkExcessMicros = (tNumberOfAllMarks > 0) ? tSumOfAllMarkExcess / tNumberOfAllMarks : MARK_EXCESS_MICROS;
+    aReport->SpaceShorteningMicros = (tNumberOfAllSpaces > 0) ? tSumOfAllSpaceShortening / tNumberOfAllSpaces : MARK_EXCESS_MICROS;
+    if (aApplyCorrection) {
+        IrReceiver.setReceiveCorrection(aReport->MarkExcessMicros, aReport->SpaceShorteningMicros);
+    }
+    return aReport->NumberOfFailedProtocols == 0;
+}
+
+/**
+ * Prints one line for each protocol with the number of decoded and sent frames and the measured timing.
+ * @param aSerial The Print object on which to write, for Arduino you can use &Serial.
+ */
+void printIRSelfTestReport(IRSelfTestReportStruct *aReport, Print *aSerial) {
+    for (uint_fast8_t i = 0; i < IR_SELF_TEST_NUMBER_OF_PROTOCOLS; i++) {
+        IRSelfTestResultStruct *tResult = &aReport->Results[i];
+        aSerial->print(getProtocolString(tResult->Protocol));
+        aSerial->print(F(": "));
+        aSerial->print(tResult->NumberOfDecodedFrames);
+        aSerial->print('/');
+        aSerial->print(tResult->NumberOfSentFrames);
+        aSerial->print(F(" decoded, mark excess="));
+        aSerial->print(tResult->MarkExcessMicros);
+        aSerial->print(F(" us, space shortening="));
+        aSerial->print(tResult->SpaceShorteningMicros);
+        aSerial->print(F(" us"));
+        if (tResult->NumberOfDecodedFrames < tResult->NumberOfSentFrames) {
+            aSerial->print(F(" FAILED"));
+        }
+        aSerial->println();
+    }
+    aSerial->print(aReport->NumberOfFailedProtocols);
+    aSerial->print(F(" protocols failed, mark excess="));
+    aSerial->print(aReport->MarkExcessMicros);
+    aSerial->print(F(" us, space shortening="));
+    aSerial->print(aReport->SpaceShorteningMicros);
+    aSerial->print(F(" us, compiled MARK_EXCESS_MICROS="));
+    aSerial->println(MARK_EXCESS_MICROS);
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_SELF_TEST_HPP
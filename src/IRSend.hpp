@@ -61,13 +61,32 @@
  * @{
  */
 
+/*
+ * Empirical values for the overhead of the software PWM and delay loops, measured for a 16 MHz AVR
+ */
+#if defined(__AVR__)
+#define MARK_END_CORRECTION_MICROS  (112 / CLOCKS_PER_MICRO) // To compensate for call duration of mark()
+#define DELAY_CORRECTION_MICROS     (64 / CLOCKS_PER_MICRO) // For reduced resolution of micros() and additional overhead
+#else
+#define MARK_END_CORRECTION_MICROS  0
+#define DELAY_CORRECTION_MICROS     0
+#endif
+
 // The sender instance
 IRsend IrSender;
 
+#if defined(ENABLE_IR_SEND_CALIBRATION)
+uint8_t IRsend::delayCorrectionMicros = DELAY_CORRECTION_MICROS;
+#endif
+
 IRsend::IRsend() { // @suppress("Class members should be properly initialized")
 #if !defined(IR_SEND_PIN)
     sendPin = 0;
 #endif
+#if defined(ENABLE_IR_SEND_CALIBRATION)
+    pulseCorrectionNanos = PULSE_CORRECTION_NANOS;
+    markEndCorrectionMicros = MARK_END_CORRECTION_MICROS;
+#endif
 
 #if !defined(NO_LED_FEEDBACK_CODE)
     setLEDFeedback(0, DO_NOT_ENABLE_LED_FEEDBACK);
@@ -86,6 +105,9 @@ void IRsend::begin(){
 #if defined(_IR_MEASURE_TIMING) && defined(_IR_TIMING_TEST_PIN)
     pinModeFast(_IR_TIMING_TEST_PIN, OUTPUT);
 #endif
+#if defined(ENABLE_IR_SEND_CALIBRATION)
+    calibrateSendTiming();
+#endif
 }
 
 /**
@@ -104,11 +126,18 @@ void IRsend::begin(bool aEnableLEDFeedback, uint_fast8_t aFeedbackLEDPin) {
     (void) aEnableLEDFeedback;
     (void) aFeedbackLEDPin;
 #endif
+#if defined(ENABLE_IR_SEND_CALIBRATION)
+    calibrateSendTiming();
+#endif
 }
 
 #else // defined(IR_SEND_PIN)
 IRsend::IRsend(uint_fast8_t aSendPin) { // @suppress("Class members should be properly initialized")
     sendPin = aSendPin;
+#  if defined(ENABLE_IR_SEND_CALIBRATION)
+    pulseCorrectionNanos = PULSE_CORRECTION_NANOS;
+    markEndCorrectionMicros = MARK_END_CORRECTION_MICROS;
+#  endif
 #  if !defined(NO_LED_FEEDBACK_CODE)
     setLEDFeedback(0, DO_NOT_ENABLE_LED_FEEDBACK);
 #  endif
@@ -123,6 +152,9 @@ void IRsend::begin(uint_fast8_t aSendPin) {
 #  if !defined(NO_LED_FEEDBACK_CODE)
     setLEDFeedback(USE_DEFAULT_FEEDBACK_LED_PIN, LED_FEEDBACK_ENABLED_FOR_SEND);
 #  endif
+#  if defined(ENABLE_IR_SEND_CALIBRATION)
+    calibrateSendTiming();
+#  endif
 }
 
 void IRsend::setSendPin(uint_fast8_t aSendPin) {
@@ -152,6 +184,9 @@ void IRsend::begin(uint_fast8_t aSendPin, bool aEnableLEDFeedback, uint_fast8_t
     (void) aEnableLEDFeedback;
     (void) aFeedbackLEDPin;
 #endif
+#if defined(ENABLE_IR_SEND_CALIBRATION)
+    calibrateSendTiming();
+#endif
 }
 #endif // defined(IR_SEND_PIN)
 
@@ -504,6 +539,66 @@ void IRsend::sendRaw_P(const uint8_t aBufferWithTicks[], uint_fast16_t aLengthOf
 #endif
 }
 
+/*
+ * Read a byte of a compressed raw buffer, which is located in FLASH for AVR and in (memory mapped) FLASH or RAM otherwise.
+ */
+static inline uint8_t readCompressedRawByte(const uint8_t *aBytePtr) {
+#if defined(__AVR__)
+    return pgm_read_byte(aBytePtr);
+#else
+    return *aBytePtr;
+#endif
+}
+
+/**
+ * Function using a compressed timing array in FLASH to save even more program memory than sendRaw_P().
+ * The array is decompressed while sending, no RAM buffer is required.
+ * Raw data starts with a Mark. No leading space as in received timing data!
+ *
+ * Format of the compressed array, as generated by IrReceiver.compensateAndPrintIRResultAsCompressedCArray():
+ * - Number of intervals as 16 bit value, low byte first.
+ * - Number of symbols (1 to 16).
+ * - Symbol dictionary: the distinct durations in microseconds as 16 bit values, low byte first.
+ * - Symbol indexes of all intervals, packed in 1 bit for 2, 2 bits for 4 and 4 bits for up to 16 symbols. MSB first.
+ * E.g. a 32 bit NEC frame with 67 intervals and 4 symbols requires 3 + 8 + 17 = 28 bytes instead of 134 for sendRaw_P().
+ */
+void IRsend::sendRawCompressed_P(const uint8_t aCompressedBuffer[], uint_fast8_t aIRFrequencyKilohertz) {
+    uint_fast16_t tNumberOfIntervals = readCompressedRawByte(&aCompressedBuffer[0])
+            | (readCompressedRawByte(&aCompressedBuffer[1]) << 8);
+    uint_fast8_t tNumberOfSymbols = readCompressedRawByte(&aCompressedBuffer[2]);
+    uint_fast8_t tBitsPerIndex = 4;
+    if (tNumberOfSymbols <= 2) {
+        tBitsPerIndex = 1;
+    } else if (tNumberOfSymbols <= 4) {
+        tBitsPerIndex = 2;
+    }
+    const uint8_t *tSymbolsPtr = &aCompressedBuffer[3];
+    const uint8_t *tIndexesPtr = tSymbolsPtr + (2 * tNumberOfSymbols);
+
+// Set IR carrier frequency
+    enableIROut(aIRFrequencyKilohertz);
+
+    uint8_t tIndexByte = 0;
+    uint_fast8_t tIndexBitsLeft = 0;
+    for (uint_fast16_t i = 0; i < tNumberOfIntervals; i++) {
+        if (tIndexBitsLeft == 0) {
+            tIndexByte = readCompressedRawByte(tIndexesPtr++);
+            tIndexBitsLeft = 8;
+        }
+        tIndexBitsLeft -= tBitsPerIndex;
+        uint_fast8_t tSymbolIndex = (tIndexByte >> tIndexBitsLeft) & ((1 << tBitsPerIndex) - 1);
+        uint16_t tDuration = readCompressedRawByte(&tSymbolsPtr[2 * tSymbolIndex])
+                | (readCompressedRawByte(&tSymbolsPtr[(2 * tSymbolIndex) + 1]) << 8);
+        if (i & 1) {
+            // Odd
+            space(tDuration);
+        } else {
+            mark(tDuration);
+        }
+    }
+    IRLedOff();  // Always end with the LED off
+}
+
 /**
  * Sends PulseDistance data from array
  * For LSB First the LSB of array[0] is sent first then all bits until MSB of array[0]. Next is LSB of array[1] and so on.
@@ -740,6 +835,75 @@ void IRsend::sendPulseDistanceWidth(PulseDistanceWidthProtocolConstants *aProtoc
     }
 }
 
+/**
+ * Sends PulseDistance frames and repeats using PulseDistanceWidthProtocolConstants stored in FLASH.
+ * This allows to keep large device tables, e.g. converted from lircd.conf files, in program memory.
+ * @param aProtocolConstantsPGM Address of the PulseDistanceWidthProtocolConstants in FLASH (declared with PROGMEM).
+ */
+void IRsend::sendPulseDistanceWidth_P(PulseDistanceWidthProtocolConstants const *aProtocolConstantsPGM, IRRawDataType aData,
+        uint_fast8_t aNumberOfBits, int_fast8_t aNumberOfRepeats) {
+    PulseDistanceWidthProtocolConstants tTemporaryPulseDistanceWidthProtocolConstants;
+    memcpy_P(&tTemporaryPulseDistanceWidthProtocolConstants, aProtocolConstantsPGM,
+            sizeof(tTemporaryPulseDistanceWidthProtocolConstants));
+    sendPulseDistanceWidth(&tTemporaryPulseDistanceWidthProtocolConstants, aData, aNumberOfBits, aNumberOfRepeats);
+}
+
+/**
+ * Sends PulseDistance data from array using PulseDistanceWidthProtocolConstants, both stored in FLASH.
+ * The data array is read chunk by chunk while sending, so there is no limit for aNumberOfBits and no RAM buffer is required.
+ * @param aProtocolConstantsPGM     Address of the PulseDistanceWidthProtocolConstants in FLASH (declared with PROGMEM).
+ * @param aDecodedRawDataArrayPGM   Address of the data array in FLASH (declared with PROGMEM).
+ */
+void IRsend::sendPulseDistanceWidthFromArray_P(PulseDistanceWidthProtocolConstants const *aProtocolConstantsPGM,
+        IRRawDataType const *aDecodedRawDataArrayPGM, uint16_t aNumberOfBits, int_fast8_t aNumberOfRepeats) {
+    PulseDistanceWidthProtocolConstants tTemporaryPulseDistanceWidthProtocolConstants;
+    memcpy_P(&tTemporaryPulseDistanceWidthProtocolConstants, aProtocolConstantsPGM,
+            sizeof(tTemporaryPulseDistanceWidthProtocolConstants));
+    DistanceWidthTimingInfoStruct *tTimingInfo = &tTemporaryPulseDistanceWidthProtocolConstants.DistanceWidthTimingInfo;
+
+    // Set IR carrier frequency
+    enableIROut(tTemporaryPulseDistanceWidthProtocolConstants.FrequencyKHz);
+
+    uint16_t tNumberOf32Or64BitChunks = ((aNumberOfBits - 1) / BITS_IN_RAW_DATA_TYPE) + 1;
+    uint_fast8_t tNumberOfCommands = aNumberOfRepeats + 1;
+    while (tNumberOfCommands > 0) {
+        auto tStartOfFrameMillis = millis();
+        auto tNumberOfBits = aNumberOfBits; // refresh value for repeats
+
+        // Header
+        mark(tTimingInfo->HeaderMarkMicros);
+        space(tTimingInfo->HeaderSpaceMicros);
+
+        for (uint16_t i = 0; i < tNumberOf32Or64BitChunks; ++i) {
+            uint8_t tNumberOfBitsForOneSend;
+            uint8_t tFlags;
+            if (i == (tNumberOf32Or64BitChunks - 1)) {
+                // End of data
+                tNumberOfBitsForOneSend = tNumberOfBits;
+                tFlags = tTemporaryPulseDistanceWidthProtocolConstants.Flags;
+            } else {
+                // intermediate data
+                tNumberOfBitsForOneSend = BITS_IN_RAW_DATA_TYPE;
+                tFlags = tTemporaryPulseDistanceWidthProtocolConstants.Flags | SUPPRESS_STOP_BIT_FOR_THIS_DATA; // No stop bit for leading data
+            }
+            IRRawDataType tData;
+            memcpy_P(&tData, &aDecodedRawDataArrayPGM[i], sizeof(tData));
+            sendPulseDistanceWidthData(tTimingInfo->OneMarkMicros, tTimingInfo->OneSpaceMicros, tTimingInfo->ZeroMarkMicros,
+                    tTimingInfo->ZeroSpaceMicros, tData, tNumberOfBitsForOneSend, tFlags);
+            tNumberOfBits -= BITS_IN_RAW_DATA_TYPE;
+        }
+
+        tNumberOfCommands--;
+        // skip last delay!
+        if (tNumberOfCommands > 0) {
+            auto tFrameDurationMillis = millis() - tStartOfFrameMillis;
+            if (tTemporaryPulseDistanceWidthProtocolConstants.RepeatPeriodMillis > tFrameDurationMillis) {
+                delay(tTemporaryPulseDistanceWidthProtocolConstants.RepeatPeriodMillis - tFrameDurationMillis);
+            }
+        }
+    }
+}
+
 /**
  * Sends PulseDistance frames and repeats.
  * @param aFrequencyKHz, aHeaderMarkMicros, aHeaderSpaceMicros, aOneMarkMicros, aOneSpaceMicros, aZeroMarkMicros, aZeroSpaceMicros, aFlags, aRepeatPeriodMillis     Values to use for sending this protocol, also contained in the PulseDistanceWidthProtocolConstants of this protocol.
@@ -951,8 +1115,13 @@ void IRsend::sendBiphaseData(uint16_t aBiphaseTimeUnit, uint32_t aData, uint_fas
  * This disturbance is no problem, if the exceedance is small and does not happen too often.
  */
 void IRsend::mark(uint16_t aMarkMicros) {
+#if defined(ENABLE_IR_SEND_RECORDER)
+    if (recordSendInterval(true, aMarkMicros)) {
+        return; // dry run
+    }
+#endif
 
-#if defined(SEND_PWM_BY_TIMER) || defined(USE_NO_SEND_PWM)
+#if defined(SEND_PWM_BY_TIMER) || defined(USE_NO_SEND_PWM) || defined(SEND_PWM_BY_SPI)
 #  if !defined(NO_LED_FEEDBACK_CODE)
     if (FeedbackLEDControl.LedFeedbackEnabled == LED_FEEDBACK_ENABLED_FOR_SEND) {
         setFeedbackLED(true);
@@ -960,7 +1129,15 @@ void IRsend::mark(uint16_t aMarkMicros) {
 #  endif
 #endif
 
-#if defined(SEND_PWM_BY_TIMER)
+#if defined(SEND_PWM_BY_SPI)
+    /*
+     * Generate carrier as bit pattern at MOSI
+     */
+    sendMarkBySPI(aMarkMicros);
+    IRLedOff(); // manages feedback LED
+    return;
+
+#elif defined(SEND_PWM_BY_TIMER)
     /*
      * Generate hardware PWM signal
      */
@@ -1078,18 +1255,27 @@ void IRsend::mark(uint16_t aMarkMicros) {
              */
             tMicros = micros();
             uint16_t tDeltaMicros = tMicros - tStartMicros;
-#if defined(__AVR__)
+#if defined(ENABLE_IR_SEND_CALIBRATION)
+#  if !defined(NO_LED_FEEDBACK_CODE)
+            if (tDeltaMicros >= aMarkMicros - (30 + markEndCorrectionMicros)) {
+                if (FeedbackLEDControl.LedFeedbackEnabled == LED_FEEDBACK_ENABLED_FOR_SEND) {
+                    setFeedbackLED(false);
+                }
+            }
+#  endif
+            if (tDeltaMicros >= aMarkMicros - markEndCorrectionMicros) {
+#elif defined(__AVR__)
             // reset feedback led in the last pause before end
 //            tDeltaMicros += (160 / CLOCKS_PER_MICRO); // adding this once increases program size, so do it below !
 #  if !defined(NO_LED_FEEDBACK_CODE)
-            if (tDeltaMicros >= aMarkMicros - (30 + (112 / CLOCKS_PER_MICRO))) { // 30 to be constant. Using periodTimeMicros increases program size too much.
+            if (tDeltaMicros >= aMarkMicros - (30 + MARK_END_CORRECTION_MICROS)) { // 30 to be constant. Using periodTimeMicros increases program size too much.
                 if (FeedbackLEDControl.LedFeedbackEnabled == LED_FEEDBACK_ENABLED_FOR_SEND) {
                     setFeedbackLED(false);
                 }
             }
 #  endif
             // Just getting variables and check for end condition takes minimal 3.8 us
-            if (tDeltaMicros >= aMarkMicros - (112 / CLOCKS_PER_MICRO)) { // To compensate for call duration - 112 is an empirical value
+            if (tDeltaMicros >= aMarkMicros - MARK_END_CORRECTION_MICROS) { // To compensate for call duration - 112 is an empirical value
 #else
             if (tDeltaMicros >= aMarkMicros) {
 #  if !defined(NO_LED_FEEDBACK_CODE)
@@ -1114,7 +1300,9 @@ void IRsend::mark(uint16_t aMarkMicros) {
  * This function may affect the state of feedback LED.
  */
 void IRsend::IRLedOff() {
-#if defined(SEND_PWM_BY_TIMER)
+#if defined(SEND_PWM_BY_SPI)
+    // Nothing to do, MOSI is low after each mark
+#elif defined(SEND_PWM_BY_TIMER)
     disableSendPWMByTimer(); // Disable PWM output
 #elif defined(USE_NO_SEND_PWM)
 #  if defined(USE_OPEN_DRAIN_OUTPUT_FOR_SEND_PIN) && !defined(OUTPUT_OPEN_DRAIN)
@@ -1147,6 +1335,11 @@ void IRsend::IRLedOff() {
  * A space is "no output", so just wait.
  */
 void IRsend::space(uint16_t aSpaceMicros) {
+#if defined(ENABLE_IR_SEND_RECORDER)
+    if (recordSendInterval(false, aSpaceMicros)) {
+        return; // dry run
+    }
+#endif
     customDelayMicroseconds(aSpaceMicros);
 }
 
@@ -1169,8 +1362,10 @@ void IRsend::customDelayMicroseconds(unsigned long aMicroseconds) {
     }
 #else
 
-#  if defined(__AVR__)
-    unsigned long start = micros() - (64 / clockCyclesPerMicrosecond()); // - (64 / clockCyclesPerMicrosecond()) for reduced resolution and additional overhead
+#  if defined(ENABLE_IR_SEND_CALIBRATION)
+    unsigned long start = micros() - delayCorrectionMicros;
+#  elif defined(__AVR__)
+    unsigned long start = micros() - DELAY_CORRECTION_MICROS; // - (64 / clockCyclesPerMicrosecond()) for reduced resolution and additional overhead
 #  else
     unsigned long start = micros();
 #  endif
@@ -1187,7 +1382,11 @@ void IRsend::customDelayMicroseconds(unsigned long aMicroseconds) {
  * If IR_SEND_PIN is defined, maximum PWM frequency for an AVR @16 MHz is 170 kHz (180 kHz if NO_LED_FEEDBACK_CODE is defined)
  */
 void IRsend::enableIROut(uint_fast8_t aFrequencyKHz) {
-#if defined(SEND_PWM_BY_TIMER)
+#if defined(SEND_PWM_BY_SPI)
+    configureSPIForSend(aFrequencyKHz); // SPI.begin() sets the pin mode of MOSI
+    return;
+
+#elif defined(SEND_PWM_BY_TIMER)
     timerConfigForSend(aFrequencyKHz); // must set output pin mode and disable receive interrupt if required, e.g. uses the same resource
 
 #elif defined(USE_NO_SEND_PWM)
@@ -1199,7 +1398,8 @@ void IRsend::enableIROut(uint_fast8_t aFrequencyKHz) {
     periodOnTimeMicros = (((periodTimeMicros * IR_SEND_DUTY_CYCLE_PERCENT) + 50) / 100U); // +50 for rounding -> 830/100 for 30% and 16 MHz
 #  else
 // Heuristics! We require a nanosecond correction for "slow" digitalWrite() functions
-    periodOnTimeMicros = (((periodTimeMicros * IR_SEND_DUTY_CYCLE_PERCENT) + 50 - (PULSE_CORRECTION_NANOS / 10)) / 100U); // +50 for rounding -> 530/100 for 30% and 16 MHz
+    int16_t tPeriodOnTime = (((periodTimeMicros * IR_SEND_DUTY_CYCLE_PERCENT) + 50 - (getPulseCorrectionNanos() / 10)) / 100); // +50 for rounding -> 530/100 for 30% and 16 MHz
+    periodOnTimeMicros = (tPeriodOnTime > 0) ? tPeriodOnTime : 1;
 #  endif
 #endif // defined(SEND_PWM_BY_TIMER)
 
@@ -1240,8 +1440,110 @@ void IRsend::enableHighFrequencyIROut(uint_fast16_t aFrequencyKHz) {
 #endif
 
 uint16_t IRsend::getPulseCorrectionNanos() {
+#if defined(ENABLE_IR_SEND_CALIBRATION)
+    return pulseCorrectionNanos;
+#else
     return PULSE_CORRECTION_NANOS;
+#endif
+}
+
+#if defined(ENABLE_IR_SEND_CALIBRATION)
+/**
+ * Measures the overhead of customDelayMicroseconds(), of digitalWrite() and delayMicroseconds() used for the PWM on time
+ * and of the end of mark(), and stores them as replacement for the empirical constants, which are only valid for a 16 MHz AVR.
+ * Measurement is done with micros() as mean of several calls, to get below the micros() resolution.
+ * Each value is taken as the minimum of 3 measurements to reduce the influence of interrupts.
+ * Called by begin(). Call it manually, if you use the IRsend() constructor and setSendPin().
+ * For software generated PWM, it sends 8 carrier bursts of 2 to 3 periods, separated by spaces of 1 ms.
+ * They are shorter than the minimum burst length of around 6 to 10 periods of common IR receiver modules, so they are usually not detected.
+ */
+void IRsend::calibrateSendTiming() {
+    uint16_t tMinimumMicros;
+#  if !defined(ESP32) && !defined(ESP8266) // They use delayMicroseconds() for customDelayMicroseconds()
+    /*
+     * Overhead of customDelayMicroseconds()
+     */
+    delayCorrectionMicros = 0;
+    tMinimumMicros = UINT16_MAX;
+    for (uint_fast8_t i = 0; i < 3; i++) {
+        unsigned long tStartMicros = micros();
+        for (uint_fast8_t j = 0; j < 32; j++) {
+            customDelayMicroseconds(100);
+        }
+        uint16_t tMicros = micros() - tStartMicros;
+        if (tMinimumMicros > tMicros) {
+            tMinimumMicros = tMicros;
+        }
+    }
+    // +16 for rounding
+    delayCorrectionMicros = (tMinimumMicros > (32 * 100)) ? (tMinimumMicros + 16 - (32 * 100)) / 32 : 0;
+#  endif
+
+#  if !defined(SEND_PWM_BY_TIMER) && !defined(USE_NO_SEND_PWM) && !defined(SEND_PWM_BY_SPI)
+    enableIROut(38); // sets pin mode and periodTimeMicros
+#    if !defined(IR_SEND_PIN)
+    /*
+     * Duration of digitalWrite(sendPin, LOW) and of the call to delayMicroseconds() for the PWM on time
+     */
+    tMinimumMicros = UINT16_MAX;
+    for (uint_fast8_t i = 0; i < 3; i++) {
+        unsigned long tStartMicros = micros();
+        for (uint_fast8_t j = 0; j < 32; j++) {
+            // The pause level of mark(), so the IR LED stays inactive
+#      if defined(USE_OPEN_DRAIN_OUTPUT_FOR_SEND_PIN) && !defined(OUTPUT_OPEN_DRAIN)
+            pinModeFast(sendPin, INPUT);
+#      else
+            digitalWriteFast(sendPin, LOW);
+#      endif
+            delayMicroseconds(8);
+        }
+        uint16_t tMicros = micros() - tStartMicros;
+        if (tMinimumMicros > tMicros) {
+            tMinimumMicros = tMicros;
+        }
+    }
+    pulseCorrectionNanos = (tMinimumMicros > (32 * 8)) ? ((tMinimumMicros - (32 * 8)) * 1000UL) / 32 : 0;
+    enableIROut(38); // compute periodOnTimeMicros with the new correction
+#    endif
+
+    /*
+     * Delay from reaching the end condition until the return of mark(), compensated for the micros() call duration
+     */
+    unsigned long tStartMicros = micros();
+    for (uint_fast8_t j = 0; j < 32; j++) {
+        micros();
+    }
+    uint16_t tMicrosCallNanos = ((micros() - tStartMicros) * 1000UL) / 33;
+
+    markEndCorrectionMicros = 0;
+    uint32_t tSumOfOvershootNanos = 0;
+    for (uint_fast8_t i = 0; i < 8; i++) {
+        // Short bursts with different offsets to the PWM period to get the mean. Too short to be detected by IR receivers.
+        uint16_t tMarkMicros = (2 * periodTimeMicros) + (i * 3);
+        tStartMicros = micros();
+        mark(tMarkMicros);
+        uint16_t tMicros = micros() - tStartMicros;
+        IRLedOff();
+        if (tMicros > tMarkMicros) {
+            tSumOfOvershootNanos += (tMicros - tMarkMicros) * 1000UL;
+        }
+        space(1000); // Let the AGC of the receiver settle, to avoid that bursts are combined
+    }
+    uint32_t tOvershootNanos = tSumOfOvershootNanos / 8;
+    markEndCorrectionMicros = (tOvershootNanos > tMicrosCallNanos) ? (tOvershootNanos - tMicrosCallNanos + 500) / 1000 : 0;
+#  endif
+
+#  if defined(LOCAL_DEBUG)
+    Serial.print(F("Send calibration: delay="));
+    Serial.print(delayCorrectionMicros);
+    Serial.print(F(" us, pulse="));
+    Serial.print(pulseCorrectionNanos);
+    Serial.print(F(" ns, mark end="));
+    Serial.print(markEndCorrectionMicros);
+    Serial.println(F(" us"));
+#  endif
 }
+#endif
 
 /** @}*/
 #if defined(_IR_MEASURE_TIMING)
@@ -0,0 +1,152 @@
+/**
+ * @file IRSendHeldKey.hpp
+ *
+ * @brief Non blocking sending of a held key.
+ * startRepeat() sends the first frame, handleRepeat() sends the repeat frames at the repeat period of the protocol
+ * and stopRepeat() ends it, like releasing the key of the remote.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_SEND_HELD_KEY_HPP
+#define _IR_SEND_HELD_KEY_HPP
+
+/** \addtogroup Sending Sending IR data for multiple protocols
+ * @{
+ */
+
+struct IRHeldKeyStruct {
+    bool IsActive;
+    decode_type_t Protocol;
+    uint16_t Address;
+    uint16_t Command;
+    uint16_t RepeatPeriodMillis;
+    unsigned long LastFrameStartMillis;
+};
+IRHeldKeyStruct sHeldKey;
+
+/**
+ * @return The period from start of one frame to start of the next frame for held keys, 110 ms for unknown protocols.
+ */
+uint16_t getRepeatPeriodMillis(decode_type_t aProtocol) {
+    if (aProtocol == SONY) {
+        return SONY_REPEAT_PERIOD / MICROS_IN_ONE_MILLI;
+    } else if (aProtocol == JVC) {
+        return JVC_REPEAT_PERIOD / MICROS_IN_ONE_MILLI;
+    } else if (aProtocol == PANASONIC || (aProtocol >= KASEIKYO && aProtocol <= KASEIKYO_MITSUBISHI)) {
+        return KASEIKYO_REPEAT_PERIOD / MICROS_IN_ONE_MILLI;
+    } else if (aProtocol == RC5 || aProtocol == RC6 || aProtocol == RC5_CDI) {
+        return RC5_REPEAT_PERIOD / MICROS_IN_ONE_MILLI;
+#if !defined(EXCLUDE_EXOTIC_PROTOCOLS)
+    } else if (aProtocol == BOSEWAVE) {
+        return BOSEWAVE_REPEAT_PERIOD / MICROS_IN_ONE_MILLI;
+    } else if (aProtocol == FAST) {
+        return FAST_REPEAT_PERIOD / MICROS_IN_ONE_MILLI;
+    } else if (aProtocol == CDTV) {
+        return CDTV_REPEAT_PERIOD / MICROS_IN_ONE_MILLI;
+#endif
+    }
+    return NEC_REPEAT_PERIOD / MICROS_IN_ONE_MILLI; // Same for Denon, LG and Samsung
+}
+
+/**
+ * Sends the first frame of a held key. Then handleRepeat() must be called in the loop until stopRepeat() is called.
+ * The toggle bit of RC5 and RC6 is inverted at each call, so the receiver can distinguish 2 presses of the same key.
+ * @param aProtocol All protocols supported by write(), and LG2.
+ */
+void IRsend::startRepeat(decode_type_t aProtocol, uint16_t aAddress, uint16_t aCommand) {
+    sHeldKey.Protocol = aProtocol;
+    sHeldKey.Address = aAddress;
+    sHeldKey.Command = aCommand;
+    sHeldKey.RepeatPeriodMillis = getRepeatPeriodMillis(aProtocol);
+    sHeldKey.LastFrameStartMillis = millis();
+    sHeldKey.IsActive = true;
+    if (aProtocol == LG2) {
+        sendLG2((uint8_t) aAddress, aCommand, 0);
+    } else if (aProtocol == RC5 || aProtocol == RC5_CDI) {
+        sendRC5((uint8_t) aAddress, (uint8_t) aCommand, 0, true);
+    } else if (aProtocol == RC6) {
+        sendRC6((uint8_t) aAddress, (uint8_t) aCommand, 0, true);
+    } else {
+        write(aProtocol, aAddress, aCommand, 0);
+    }
+}
+
+/**
+ * Sends the next repeat frame, if the repeat period has elapsed.
+ * Uses the special repeat frame for NEC, Apple, Onkyo, LG, LG2, Samsung and SamsungLG and the frame without header for JVC,
+ * otherwise the first frame is sent again. RC5 and RC6 frames keep the toggle bit of the first frame.
+ * Call it in the loop as often as possible, since it returns immediately if no frame is due.
+ * @return true if a frame was sent.
+ */
+bool IRsend::handleRepeat() {
+    if (!sHeldKey.IsActive || millis() - sHeldKey.LastFrameStartMillis < sHeldKey.RepeatPeriodMillis) {
+        return false;
+    }
+    // Keep the raster of the repeat period, even if we were called late
+    sHeldKey.LastFrameStartMillis += sHeldKey.RepeatPeriodMillis;
+    if (millis() - sHeldKey.LastFrameStartMillis >= sHeldKey.RepeatPeriodMillis) {
+        sHeldKey.LastFrameStartMillis = millis(); // we are more than one period late, start a new raster
+    }
+
+    decode_type_t tProtocol = sHeldKey.Protocol;
+    if (tProtocol == NEC || tProtocol == APPLE || tProtocol == ONKYO || tProtocol == LG) {
+        sendNECRepeat();
+    } else if (tProtocol == SAMSUNG || tProtocol == SAMSUNG_LG) {
+        sendSamsungLGRepeat();
+    } else if (tProtocol == LG2) {
+        sendLG2Repeat();
+    } else if (tProtocol == JVC) {
+        sendJVC((uint8_t) sHeldKey.Address, (uint8_t) sHeldKey.Command, -1); // JVC repeats by skipping the header
+    } else if (tProtocol == RC5 || tProtocol == RC5_CDI || tProtocol == RC6) {
+        // Invert the last toggle value, so that the automatic toggle of the send function sends it again unchanged
+        sLastSendToggleValue ^= 1;
+        if (tProtocol == RC6) {
+            sendRC6((uint8_t) sHeldKey.Address, (uint8_t) sHeldKey.Command, 0, true);
+        } else {
+            sendRC5((uint8_t) sHeldKey.Address, (uint8_t) sHeldKey.Command, 0, true);
+        }
+    } else {
+        write(tProtocol, sHeldKey.Address, sHeldKey.Command, 0);
+    }
+    IRLedOff(); // Always end with the LED off
+    return true;
+}
+
+/**
+ * Stops sending of repeat frames. No further frame is sent, so the receiver detects the release of the key
+ * at the latest one repeat period after this call.
+ */
+void IRsend::stopRepeat() {
+    sHeldKey.IsActive = false;
+}
+
+bool IRsend::isRepeating() {
+    return sHeldKey.IsActive;
+}
+
+/** @}*/
+#endif // _IR_SEND_HELD_KEY_HPP
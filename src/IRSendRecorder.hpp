@@ -0,0 +1,177 @@
+/**
+ * @file IRSendRecorder.hpp
+ *
+ * @brief Recording of the intervals sent by mark() and space(), to measure the timing accuracy and the encoding cost of the send functions.
+ * For each interval the requested duration and the duration measured by micros() from the start of this interval to the start of the next one is stored.
+ * In dry run mode nothing is sent and the intervals are only recorded, so the elapsed time is the encoding cost of the send function.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_SEND_RECORDER_HPP
+#define _IR_SEND_RECORDER_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Sending Sending IR data for multiple protocols
+ * @{
+ */
+
+/**
+ * The recorded intervals. RequestedMicros can be used for sendRaw() or printRawMicrosAsVCD().
+ */
+struct IRSendRecorderStruct {
+    uint16_t RequestedMicros[IR_SEND_RECORDER_SIZE];
+    uint16_t MeasuredMicros[IR_SEND_RECORDER_SIZE]; ///< 0 if not measured, i.e. for dry run or for the last mark before a delay between repeats
+    uint8_t IsMarkBits[(IR_SEND_RECORDER_SIZE + 7) / 8];
+    uint16_t NumberOfIntervals; ///< IR_SEND_RECORDER_SIZE + 1 signals an overflow
+    uint32_t StartMicros;
+    uint32_t DurationMicros; ///< Duration from startRecording() to stopRecording(). For dry run, this is the encoding cost.
+    uint32_t LastIntervalStartMicros;
+    bool LastIntervalWasMark;
+    bool IsRecording;
+    bool IsDryRun;
+};
+IRSendRecorderStruct sIRSendRecorder;
+
+/**
+ * Starts recording of all following mark() and space() calls. A previous recording is discarded.
+ * @param aDryRun   If true, mark() and space() return immediately without sending, but delays between repeats are still executed.
+ */
+void IRsend::startRecording(bool aDryRun) {
+    sIRSendRecorder.NumberOfIntervals = 0;
+    sIRSendRecorder.IsDryRun = aDryRun;
+    sIRSendRecorder.IsRecording = true;
+    sIRSendRecorder.StartMicros = micros();
+}
+
+/**
+ * Stops recording. Call it directly after the send function, since the measured duration of the last interval ends here.
+ */
+void IRsend::stopRecording() {
+    uint32_t tMicros = micros();
+    sIRSendRecorder.IsRecording = false;
+    sIRSendRecorder.DurationMicros = tMicros - sIRSendRecorder.StartMicros;
+    uint_fast16_t tLastIndex = sIRSendRecorder.NumberOfIntervals - 1;
+    if (sIRSendRecorder.NumberOfIntervals > 0 && tLastIndex < IR_SEND_RECORDER_SIZE && !sIRSendRecorder.IsDryRun) {
+        sIRSendRecorder.MeasuredMicros[tLastIndex] = tMicros - sIRSendRecorder.LastIntervalStartMicros;
+    }
+}
+
+/*
+ * Called at the start of mark() and space()
+ * @return true for dry run, i.e. if the interval must not be sent
+ */
+bool recordSendInterval(bool aIsMark, uint16_t aMicros) {
+    if (!sIRSendRecorder.IsRecording) {
+        return false;
+    }
+    uint32_t tMicros = micros();
+    uint_fast16_t tIndex = sIRSendRecorder.NumberOfIntervals;
+    if (tIndex > 0 && tIndex <= IR_SEND_RECORDER_SIZE && !sIRSendRecorder.IsDryRun) {
+        // Two marks in sequence are separated by a delay() between repeats, which is not recorded
+        sIRSendRecorder.MeasuredMicros[tIndex - 1] =
+                (aIsMark == sIRSendRecorder.LastIntervalWasMark) ? 0 : tMicros - sIRSendRecorder.LastIntervalStartMicros;
+    }
+    if (tIndex < IR_SEND_RECORDER_SIZE) {
+        sIRSendRecorder.RequestedMicros[tIndex] = aMicros;
+        sIRSendRecorder.MeasuredMicros[tIndex] = 0;
+        if (aIsMark) {
+            sIRSendRecorder.IsMarkBits[tIndex / 8] |= (1 << (tIndex & 7));
+        } else {
+            sIRSendRecorder.IsMarkBits[tIndex / 8] &= ~(1 << (tIndex & 7));
+        }
+    }
+    if (tIndex <= IR_SEND_RECORDER_SIZE) {
+        sIRSendRecorder.NumberOfIntervals = tIndex + 1; // The value IR_SEND_RECORDER_SIZE + 1 signals an overflow
+    }
+    sIRSendRecorder.LastIntervalWasMark = aIsMark;
+    sIRSendRecorder.LastIntervalStartMicros = tMicros;
+    return sIRSendRecorder.IsDryRun;
+}
+
+/**
+ * Prints the recorded intervals as +mark and -space durations, each followed by the timing error in parenthesis.
+ * The error is the measured minus the requested duration. It includes the micros() resolution, which is 4 us for AVR.
+ */
+void IRsend::printRecording(Print *aSerial) {
+    uint_fast16_t tNumberOfIntervals = sIRSendRecorder.NumberOfIntervals;
+    if (tNumberOfIntervals > IR_SEND_RECORDER_SIZE) {
+        aSerial->print(F("Recording overflow, only "));
+        tNumberOfIntervals = IR_SEND_RECORDER_SIZE;
+    }
+    aSerial->print(tNumberOfIntervals);
+    aSerial->print(F(" intervals recorded in "));
+    aSerial->print(sIRSendRecorder.DurationMicros);
+    aSerial->print(F(" us"));
+    if (sIRSendRecorder.IsDryRun) {
+        aSerial->print(F(" without sending"));
+    }
+    aSerial->println();
+
+    int16_t tMaximumError = 0;
+    uint_fast16_t tMaximumErrorIndex = 0;
+    for (uint_fast16_t i = 0; i < tNumberOfIntervals; i++) {
+        aSerial->print((sIRSendRecorder.IsMarkBits[i / 8] & (1 << (i & 7))) ? '+' : '-');
+        aSerial->print(sIRSendRecorder.RequestedMicros[i]);
+        if (sIRSendRecorder.MeasuredMicros[i] != 0) {
+            int16_t tError = sIRSendRecorder.MeasuredMicros[i] - sIRSendRecorder.RequestedMicros[i];
+            aSerial->print('(');
+            if (tError >= 0) {
+                aSerial->print('+');
+            }
+            aSerial->print(tError);
+            aSerial->print(')');
+            if (abs(tError) > abs(tMaximumError)) {
+                tMaximumError = tError;
+                tMaximumErrorIndex = i;
+            }
+        }
+        aSerial->print(' ');
+        if ((i & 7) == 7) {
+            aSerial->println();
+        }
+    }
+    if ((tNumberOfIntervals & 7) != 0) {
+        aSerial->println();
+    }
+    if (!sIRSendRecorder.IsDryRun) {
+        aSerial->print(F("Maximum error="));
+        aSerial->print(tMaximumError);
+        aSerial->print(F(" us at index "));
+        aSerial->println(tMaximumErrorIndex);
+    }
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_SEND_RECORDER_HPP
@@ -0,0 +1,102 @@
+/**
+ * @file IRSendSPI.hpp
+ *
+ * @brief Generation of the send carrier as bit pattern at the MOSI pin of the SPI hardware.
+ * A mark is sent as a sequence of carrier periods clocked out with IR_SPI_BIT_RATE, so its carrier is not disturbed by interrupts
+ * and no PWM timer pin is required. A space is just a delay, since MOSI stays at the level of the last bit, which is always 0.
+ * Cores providing a block write, which does not overwrite the buffer, use it to stream the bytes without gaps.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_SEND_SPI_HPP
+#define _IR_SEND_SPI_HPP
+
+#include <SPI.h>
+#include "IRSPICarrierPattern.hpp"
+
+/** \addtogroup Sending Sending IR data for multiple protocols
+ * @{
+ */
+/*
+ * Functions declared here
+ */
+void configureSPIForSend(uint_fast8_t aFrequencyKHz);
+void sendMarkBySPI(uint16_t aMarkMicros);
+
+uint8_t sSPICarrierPattern[IR_SPI_PATTERN_SIZE];
+uint16_t sSPICarrierPatternLength; // in bytes
+uint8_t sSPICarrierFrequencyKHz; // 0 before first call of configureSPIForSend()
+
+/**
+ * Called by enableIROut(). Computes the pattern only if the frequency changed.
+ */
+void configureSPIForSend(uint_fast8_t aFrequencyKHz) {
+    if (sSPICarrierFrequencyKHz == aFrequencyKHz) {
+        return;
+    }
+    if (sSPICarrierFrequencyKHz == 0) {
+        SPI.begin();
+    }
+    sSPICarrierFrequencyKHz = aFrequencyKHz;
+    sSPICarrierPatternLength = computeSPICarrierPattern(sSPICarrierPattern, IR_SPI_PATTERN_SIZE, IR_SPI_BIT_RATE,
+            aFrequencyKHz * 1000UL, IR_SEND_DUTY_CYCLE_PERCENT);
+}
+
+static void writeSPIBytes(const uint8_t *aBytes, uint16_t aNumberOfBytes) {
+#if defined(ESP32) || defined(ESP8266)
+    SPI.writeBytes(aBytes, aNumberOfBytes);
+#else // arduino-pico, other cores are rejected in IRremote.hpp
+    SPI.transfer(aBytes, NULL, aNumberOfBytes);
+#endif
+}
+
+/**
+ * Sends the carrier pattern for aMarkMicros, rounded to whole bytes.
+ * If the last sent bit is 1, a 0 byte is appended, to leave MOSI low for the following space.
+ */
+void sendMarkBySPI(uint16_t aMarkMicros) {
+    uint32_t tNumberOfBytes = (((uint32_t) aMarkMicros * (IR_SPI_BIT_RATE / 1000)) / 1000 + 4) / 8;
+    uint16_t tPatternLength = sSPICarrierPatternLength;
+    uint8_t tLastByte = 0;
+    SPI.beginTransaction(SPISettings(IR_SPI_BIT_RATE, MSBFIRST, SPI_MODE0));
+    while (tNumberOfBytes >= tPatternLength) {
+        writeSPIBytes(sSPICarrierPattern, tPatternLength);
+        tNumberOfBytes -= tPatternLength;
+        tLastByte = sSPICarrierPattern[tPatternLength - 1];
+    }
+    if (tNumberOfBytes > 0) {
+        writeSPIBytes(sSPICarrierPattern, tNumberOfBytes);
+        tLastByte = sSPICarrierPattern[tNumberOfBytes - 1];
+    }
+    if (tLastByte & 0x01) {
+        SPI.transfer(0);
+    }
+    SPI.endTransaction();
+}
+
+/** @}*/
+#endif // _IR_SEND_SPI_HPP
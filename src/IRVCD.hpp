@@ -0,0 +1,272 @@
+/**
+ * @file IRVCD.hpp
+ *
+ * @brief Export and import of IR signals in the Value Change Dump (VCD) format of logic analyzers and simulators.
+ * The export functions print received raw data or a sendRaw() array as VCD, which can be viewed with e.g. GTKWave or PulseView.
+ * The import parses a VCD file character by character and feeds the level changes of one 1 bit signal to feedDuration(),
+ * so traces of any length, e.g. read from SD card, can be decoded. Sigrok captures can be converted to VCD by sigrok-cli -O vcd.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_VCD_HPP
+#define _IR_VCD_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Receiving Receiving IR data for multiple protocols
+ * @{
+ */
+
+#define IR_VCD_SECTION_NONE         0 // Value changes and timestamps are evaluated
+#define IR_VCD_SECTION_TIMESCALE    1
+#define IR_VCD_SECTION_VAR          2
+#define IR_VCD_SECTION_SKIP         3 // Sections like $comment or $scope, which are skipped up to $end
+
+#define IR_VCD_MAXIMUM_TOKEN_LENGTH         23
+#define IR_VCD_MAXIMUM_IDENTIFIER_LENGTH    4
+
+/*
+ * State of the VCD parser
+ */
+struct IRVCDImportStruct {
+    char Token[IR_VCD_MAXIMUM_TOKEN_LENGTH + 1];
+    uint8_t TokenLength;
+    uint8_t Section;
+    uint8_t TokenIndexInSection;
+    bool IsVarOf1Bit;
+    bool SkipNextToken; // The next token is the identifier of a vector value change
+    char VarIdentifier[IR_VCD_MAXIMUM_IDENTIFIER_LENGTH + 1]; // Identifier code of the current $var
+    char Identifier[IR_VCD_MAXIMUM_IDENTIFIER_LENGTH + 1]; // Identifier code of the receive signal, empty if not yet found
+    const char *SignalName; // Reference name of the receive signal, NULL for the first 1 bit signal
+    uint32_t TimescaleMultiplier; // Time in micros = time * TimescaleMultiplier / TimescaleDivisor
+    uint32_t TimescaleDivisor;
+    uint64_t CurrentTime;
+    uint64_t LastChangeTime;
+    int8_t Level; // -1 before the first value change
+    bool MarkIsLow;
+};
+IRVCDImportStruct sIRVCDImport;
+
+/*
+ * Print helper for the export functions
+ */
+static void printVCDHeader(Print *aSerial) {
+    aSerial->println(F("$timescale 1 us $end"));
+    aSerial->println(F("$scope module IRremote $end"));
+    aSerial->println(F("$var wire 1 ! IR $end"));
+    aSerial->println(F("$upscope $end"));
+    aSerial->println(F("$enddefinitions $end"));
+}
+static void printVCDChange(Print *aSerial, uint32_t aTimeMicros, bool aIsMark) {
+    aSerial->print('#');
+    aSerial->println(aTimeMicros);
+    aSerial->print((char) ('0' + (aIsMark ? INPUT_MARK : !INPUT_MARK)));
+    aSerial->println('!');
+}
+
+/**
+ * Prints the received raw data as VCD with 1 us resolution. The level is the one of the receiver output.
+ * The durations are not compensated with MARK_EXCESS_MICROS, so they can be compared directly with a logic analyzer trace of the receive pin.
+ */
+void IRrecv::printIRResultAsVCD(Print *aSerial) {
+    printVCDHeader(aSerial);
+    printVCDChange(aSerial, 0, false);
+    uint32_t tTimeMicros = (uint32_t) decodedIRData.rawDataPtr->rawbuf[0] * MICROS_PER_TICK;
+    for (uint_fast16_t i = 1; i < decodedIRData.rawDataPtr->rawlen; i++) {
+        printVCDChange(aSerial, tTimeMicros, (i & 1)); // on odd rawbuf offsets we have mark timings
+        tTimeMicros += (uint32_t) decodedIRData.rawDataPtr->rawbuf[i] * MICROS_PER_TICK;
+    }
+    printVCDChange(aSerial, tTimeMicros, false);
+    aSerial->print('#');
+    aSerial->println(tTimeMicros + RECORD_GAP_MICROS);
+}
+
+/**
+ * Prints an array in the format of sendRaw() as VCD with 1 us resolution, e.g. to compare encoder output with a logic analyzer trace.
+ * The level is the one of a receiver output. A leading gap of RECORD_GAP_MICROS is added, to enable import by feedVCDCharacter().
+ * @param aBufferWithMicroseconds Mark and space durations, starting with a mark.
+ */
+void printRawMicrosAsVCD(Print *aSerial, const uint16_t aBufferWithMicroseconds[], uint_fast16_t aLengthOfBuffer) {
+    printVCDHeader(aSerial);
+    printVCDChange(aSerial, 0, false);
+    uint32_t tTimeMicros = RECORD_GAP_MICROS;
+    for (uint_fast16_t i = 0; i < aLengthOfBuffer; i++) {
+        printVCDChange(aSerial, tTimeMicros, !(i & 1)); // on even array offsets we have mark timings
+        tTimeMicros += aBufferWithMicroseconds[i];
+    }
+    printVCDChange(aSerial, tTimeMicros, false);
+    aSerial->print('#');
+    aSerial->println(tTimeMicros + RECORD_GAP_MICROS);
+}
+
+/**
+ * Resets the VCD parser. Must be called before the first character of a VCD file is fed.
+ * @param aMarkIsLow    true for a trace of the active low output of a demodulating receiver module.
+ * @param aSignalName   Reference name of the receive signal in the $var declaration, e.g. "D1" for sigrok. NULL for the first 1 bit signal.
+ */
+void IRrecv::startVCDImport(bool aMarkIsLow, const char *aSignalName) {
+    memset(&sIRVCDImport, 0, sizeof(sIRVCDImport));
+    sIRVCDImport.SignalName = aSignalName;
+    sIRVCDImport.TimescaleMultiplier = 1; // VCD files without $timescale are taken as 1 us
+    sIRVCDImport.TimescaleDivisor = 1;
+    sIRVCDImport.Level = -1;
+    sIRVCDImport.MarkIsLow = aMarkIsLow;
+}
+
+/*
+ * Evaluates one complete token of a VCD file
+ * @return true if a frame is complete
+ */
+static bool processVCDToken(IRrecv *aReceiver) {
+    char *tToken = sIRVCDImport.Token;
+    if (sIRVCDImport.SkipNextToken) {
+        sIRVCDImport.SkipNextToken = false;
+        return false;
+    }
+
+    if (tToken[0] == '$') {
+        if (strcmp(tToken, "$end") == 0 || strncmp(tToken, "$dump", 5) == 0) {
+            // The value changes in $dumpvars etc. are evaluated as usual
+            sIRVCDImport.Section = IR_VCD_SECTION_NONE;
+        } else if (strcmp(tToken, "$timescale") == 0) {
+            sIRVCDImport.Section = IR_VCD_SECTION_TIMESCALE;
+        } else if (strcmp(tToken, "$var") == 0) {
+            sIRVCDImport.Section = IR_VCD_SECTION_VAR;
+            sIRVCDImport.TokenIndexInSection = 0;
+        } else {
+            sIRVCDImport.Section = IR_VCD_SECTION_SKIP;
+        }
+        return false;
+    }
+
+    if (sIRVCDImport.Section == IR_VCD_SECTION_TIMESCALE) {
+        // "1us" or "1 us"
+        if (tToken[0] >= '0' && tToken[0] <= '9') {
+            sIRVCDImport.TimescaleMultiplier = strtoul(tToken, &tToken, 10);
+            sIRVCDImport.TimescaleDivisor = 1;
+        }
+        if (strcmp(tToken, "s") == 0) {
+            sIRVCDImport.TimescaleMultiplier *= 1000000UL;
+        } else if (strcmp(tToken, "ms") == 0) {
+            sIRVCDImport.TimescaleMultiplier *= 1000;
+        } else if (strcmp(tToken, "ns") == 0) {
+            sIRVCDImport.TimescaleDivisor = 1000;
+        } else if (strcmp(tToken, "ps") == 0) {
+            sIRVCDImport.TimescaleDivisor = 1000000UL;
+        } else if (strcmp(tToken, "fs") == 0) {
+            sIRVCDImport.TimescaleDivisor = 1000000000UL;
+        }
+        return false;
+    }
+
+    if (sIRVCDImport.Section == IR_VCD_SECTION_VAR) {
+        // $var <type> <size> <identifier> <reference> $end
+        if (sIRVCDImport.TokenIndexInSection == 1) {
+            sIRVCDImport.IsVarOf1Bit = (strcmp(tToken, "1") == 0);
+        } else if (sIRVCDImport.TokenIndexInSection == 2) {
+            strncpy(sIRVCDImport.VarIdentifier, tToken, IR_VCD_MAXIMUM_IDENTIFIER_LENGTH);
+        } else if (sIRVCDImport.TokenIndexInSection == 3 && sIRVCDImport.IsVarOf1Bit && sIRVCDImport.Identifier[0] == '\0'
+                && (sIRVCDImport.SignalName == NULL || strcmp(tToken, sIRVCDImport.SignalName) == 0)) {
+            strcpy(sIRVCDImport.Identifier, sIRVCDImport.VarIdentifier);
+        }
+        sIRVCDImport.TokenIndexInSection++;
+        return false;
+    }
+
+    if (sIRVCDImport.Section == IR_VCD_SECTION_SKIP) {
+        return false;
+    }
+
+    /*
+     * Timestamps and value changes here
+     */
+    if (tToken[0] == '#') {
+        uint64_t tTime = 0;
+        for (uint_fast8_t i = 1; tToken[i] >= '0' && tToken[i] <= '9'; i++) {
+            tTime = (tTime * 10) + (tToken[i] - '0');
+        }
+        sIRVCDImport.CurrentTime = tTime;
+        return false;
+    }
+    if (tToken[0] == 'b' || tToken[0] == 'B' || tToken[0] == 'r' || tToken[0] == 'R') {
+        sIRVCDImport.SkipNextToken = true;
+        return false;
+    }
+    if ((tToken[0] != '0' && tToken[0] != '1') || strcmp(&tToken[1], sIRVCDImport.Identifier) != 0) {
+        return false; // x or z, or value change of another variable
+    }
+
+    int8_t tLevel = tToken[0] - '0';
+    bool tIsMark = ((tLevel == 0) == sIRVCDImport.MarkIsLow);
+    if (sIRVCDImport.Level < 0) {
+        // First value. A trace normally starts while idle, so take the start as end of a long gap, like after power up
+        sIRVCDImport.Level = tLevel;
+        sIRVCDImport.LastChangeTime = sIRVCDImport.CurrentTime;
+        if (!tIsMark) {
+            return aReceiver->feedDuration(false, UINT32_MAX);
+        }
+        return false;
+    }
+    if (tLevel == sIRVCDImport.Level) {
+        return false;
+    }
+    uint64_t tDurationMicros = ((sIRVCDImport.CurrentTime - sIRVCDImport.LastChangeTime) * sIRVCDImport.TimescaleMultiplier)
+            / sIRVCDImport.TimescaleDivisor;
+    sIRVCDImport.Level = tLevel;
+    sIRVCDImport.LastChangeTime = sIRVCDImport.CurrentTime;
+    return aReceiver->feedDuration(!tIsMark, (tDurationMicros > UINT32_MAX) ? UINT32_MAX : tDurationMicros);
+}
+
+/**
+ * Feeds one character of a VCD file to the parser. Call startVCDImport() before the first character.
+ * At the end of the file, call feedDuration(false, RECORD_GAP_MICROS + MICROS_PER_TICK) to end the last frame.
+ * @return true if a frame is complete and can be decoded by decode(). Call resume() after decoding.
+ */
+bool IRrecv::feedVCDCharacter(char aCharacter) {
+    if (aCharacter == ' ' || aCharacter == '\t' || aCharacter == '\r' || aCharacter == '\n') {
+        if (sIRVCDImport.TokenLength == 0) {
+            return false;
+        }
+        sIRVCDImport.Token[sIRVCDImport.TokenLength] = '\0';
+        sIRVCDImport.TokenLength = 0;
+        return processVCDToken(this);
+    }
+    if (sIRVCDImport.TokenLength < IR_VCD_MAXIMUM_TOKEN_LENGTH) {
+        sIRVCDImport.Token[sIRVCDImport.TokenLength++] = aCharacter;
+    }
+    return false;
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_VCD_HPP
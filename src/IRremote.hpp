@@ -48,6 +48,7 @@
  * - IR_SEND_PIN                        If specified (as constant), reduces program size and improves send timing for AVR.
  * - SEND_PWM_BY_TIMER                  Disable carrier PWM generation in software and use (restricted) hardware PWM.
  * - USE_NO_SEND_PWM                    Use no carrier PWM, just simulate an **active low** receiver signal. Overrides SEND_PWM_BY_TIMER definition.
+ * - SEND_PWM_BY_SPI                    Generate the carrier as bit pattern at the MOSI pin of the SPI hardware.
  * - USE_OPEN_DRAIN_OUTPUT_FOR_SEND_PIN Use or simulate open drain output mode at send pin. Attention, active state of open drain is LOW, so connect the send LED between positive supply and send pin!
  * - EXCLUDE_EXOTIC_PROTOCOLS           If activated, BANG_OLUFSEN, BOSEWAVE, WHYNTER, FAST and LEGO_PF are excluded in decode() and in sending with IrSender.write().
  * - EXCLUDE_UNIVERSAL_PROTOCOLS        If activated, the universal decoder for pulse distance protocols and decodeHash (special decoder for all protocols) are excluded in decode().
@@ -57,6 +58,23 @@
  * - FEEDBACK_LED_IS_ACTIVE_LOW         Required on some boards (like my BluePill and my ESP8266 board), where the feedback LED is active low.
  * - NO_LED_FEEDBACK_CODE               This completely disables the LED feedback code for send and receive.
  * - IR_INPUT_IS_ACTIVE_HIGH            Enable it if you use a RF receiver, which has an active HIGH output signal.
+ * - USE_NON_DEMODULATING_RECEIVER      Use a non demodulating receiver module for learning, which additionally measures the carrier frequency.
+ * - ENABLE_IR_LEARNING                 Enable learning of raw codes from multiple captures of the same button.
+ * - ENABLE_USER_DECODERS               Enable registering of user decoders at a chosen priority in the decode() chain.
+ * - ENABLE_IR_REPEATER                 Enable forwarding of the received signal to the send pin with a fixed delay.
+ * - ENABLE_IR_BRIDGE                   Enable table driven translation of received codes to other codes to send.
+ * - ENABLE_IR_BYTECODE                 Enable sending of protocols described by bytecode with IrSender.sendBytecode().
+ * - ENABLE_IR_HELD_KEY                 Enable non blocking sending of held keys with IrSender.startRepeat() and IrSender.handleRepeat().
+ * - ENABLE_IR_RESULT_FIFO              Enable storing of decoded results in a FIFO, which is read by IrReceiver.read().
+ * - ENABLE_IR_PIPELINE                 Enable buffering of received raw frames by the ISR and decoding them in a separate task.
+ * - ENABLE_IR_CORE1_ENGINE             Enable receiving, decoding and sending on core 1 of the RP2040.
+ * - ENABLE_IR_FEED                     Enable receiving from recorded durations or PCM samples instead of the receive pin.
+ * - ENABLE_IR_VCD                      Enable export and import of the Value Change Dump format of logic analyzers.
+ * - ENABLE_IR_SPI_CAPTURE              Enable receiving from a bit stream sampled by SPI or I2S with a high rate.
+ * - ENABLE_IR_SEND_RECORDER            Enable recording of sent intervals to measure timing accuracy and encoding cost.
+ * - ENABLE_IR_SEND_CALIBRATION         Enable measuring of the software PWM and delay overheads at IrSender.begin().
+ * - ENABLE_IR_SELF_TEST                Enable the loopback self test, which measures and corrects the receiver timing.
+ * - ENABLE_ADDRESS_FILTER              Enable dropping of NEC, Samsung and Kaseikyo frames with addresses not in an allow-list before decoding.
  * - IR_SEND_DUTY_CYCLE_PERCENT         Duty cycle of IR send signal.
  * - MICROS_PER_TICK                    Resolution of the raw input buffer data. Corresponds to 2 pulses of each 26.3 us at 38 kHz.
  * - IR_USE_AVR_TIMER*                  Selection of timer to be used for generating IR receiving sample interval.
@@ -89,7 +107,8 @@
 || defined(DECODE_PANASONIC) || defined(DECODE_LG) || defined(DECODE_NEC) || defined(DECODE_ONKYO) || defined(DECODE_SAMSUNG) \
 || defined(DECODE_SONY) || defined(DECODE_RC5) || defined(DECODE_RC6) \
 || defined(DECODE_DISTANCE_WIDTH) || defined(DECODE_HASH) || defined(DECODE_BOSEWAVE) \
-|| defined(DECODE_LEGO_PF) || defined(DECODE_MAGIQUEST) || defined(DECODE_FAST) || defined(DECODE_WHYNTER) || defined(DECODE_CDTV) || defined(DECODE_RC5_CDI)))
+|| defined(DECODE_LEGO_PF) || defined(DECODE_MAGIQUEST) || defined(DECODE_FAST) || defined(DECODE_WHYNTER) || defined(DECODE_CDTV) || defined(DECODE_RC5_CDI) \
+|| defined(DECODE_DESCRIPTOR)))
 /*
  * If no protocol is explicitly enabled, we enable all protocols
  */
@@ -122,6 +141,16 @@
 #endif // !defined(NO_DECODER)
 
 //#define DECODE_BEO // Bang & Olufsen protocol always must be enabled explicitly. It prevents decoding of SONY!
+//#define DECODE_DESCRIPTOR // Generic decoder for the descriptors set by IrReceiver.setDescriptorTable_P() or loadDescriptor() must be enabled explicitly.
+//#define ENABLE_DESCRIPTOR_LOADING // Enables IrReceiver.loadDescriptor() for descriptors loaded at runtime e.g. from EEPROM. Requires DECODE_DESCRIPTOR.
+#if defined(ENABLE_DESCRIPTOR_LOADING)
+#  if !defined(DECODE_DESCRIPTOR)
+#error ENABLE_DESCRIPTOR_LOADING requires DECODE_DESCRIPTOR
+#  endif
+#  if !defined(IR_NUMBER_OF_LOADABLE_DESCRIPTORS)
+#define IR_NUMBER_OF_LOADABLE_DESCRIPTORS   4 // Number of descriptors which can be loaded at runtime by IrReceiver.loadDescriptor(). Each requires around 50 bytes of RAM.
+#  endif
+#endif
 
 #if defined(DECODE_NEC) && !(~(~DECODE_NEC + 0) == 0 && ~(~DECODE_NEC + 1) == 1)
 #warning "The macros DECODE_XXX no longer require a value. Decoding is now switched by defining / non defining the macro."
@@ -147,6 +176,9 @@
  *  VS1838      Mark Excess -50 at low intensity to +50 us at high intensity
  *  TSOP31238   Mark Excess 0 to +50
  */
+#if !defined(MARK_EXCESS_MICROS) && defined(USE_NON_DEMODULATING_RECEIVER)
+#define MARK_EXCESS_MICROS    0 // The envelope is computed from the carrier pulses, so there is no signal forming by a demodulator
+#endif
 #if !defined(MARK_EXCESS_MICROS)
 // To change this value, you simply can add a line #define "MARK_EXCESS_MICROS <My_new_value>" in your ino file before the line "#include <IRremote.hpp>"
 #define MARK_EXCESS_MICROS    20
@@ -170,6 +202,203 @@
 #define RECORD_GAP_MICROS_WARNING_THRESHOLD   15000
 #endif
 
+/**
+ * Define to use a non demodulating IR receiver module like the TSMP58000 or QSE159 for learning IR codes with their carrier frequency.
+ * Every carrier pulse triggers an edge interrupt, the receive timer is not used. The receive pin must be interrupt capable.
+ * Carrier frequency and duty cycle of the last frame are available by IrReceiver.getCarrierFrequencyHertz() and getCarrierDutyCyclePercent().
+ * Since no edge occurs at the end of a frame, the end is only detected by polling available(), decode() or isIdle() in the loop.
+ * Therefore registerReceiveCompleteCallback() and ENABLE_IR_RESULT_FIFO are not available in this mode.
+ */
+//#define USE_NON_DEMODULATING_RECEIVER
+#if defined(USE_NON_DEMODULATING_RECEIVER)
+/**
+ * Maximum carrier period accepted for frequency measurement. 50 us corresponds to 20 kHz.
+ * Greater values are caused by missed edges or by the end of a mark.
+ */
+#  if !defined(IR_CARRIER_MAXIMUM_PERIOD_MICROS)
+#define IR_CARRIER_MAXIMUM_PERIOD_MICROS    50
+#  endif
+/**
+ * A pause between two carrier pulses longer than this value is taken as a space. Must be smaller than the shortest space of a protocol.
+ */
+#  if !defined(IR_CARRIER_SPACE_THRESHOLD_MICROS)
+#define IR_CARRIER_SPACE_THRESHOLD_MICROS   100
+#  endif
+#endif
+
+/**
+ * Define to enable learning of clean raw timings from multiple captures of the same button, see IRLearning.hpp.
+ * Requires IR_LEARNING_NUMBER_OF_CAPTURES * RAW_BUFFER_LENGTH bytes of RAM.
+ */
+//#define ENABLE_IR_LEARNING
+#if defined(ENABLE_IR_LEARNING)
+#  if !defined(IR_LEARNING_NUMBER_OF_CAPTURES)
+#define IR_LEARNING_NUMBER_OF_CAPTURES  5
+#  endif
+#  if IR_LEARNING_NUMBER_OF_CAPTURES > 16
+#error IR_LEARNING_NUMBER_OF_CAPTURES must not be greater than 16
+#  endif
+#endif
+
+/**
+ * Define to enable IrReceiver.registerDecoder() for user decoders, which are called by decode() before or after the built-in decoders.
+ */
+//#define ENABLE_USER_DECODERS
+#if defined(ENABLE_USER_DECODERS)
+#  if !defined(IR_NUMBER_OF_USER_DECODERS)
+#define IR_NUMBER_OF_USER_DECODERS  4
+#  endif
+#endif
+
+/**
+ * Define to enable IrReceiver.startRepeater(), which forwards the received signal with a fixed delay to the send pin, see IRRepeater.hpp.
+ * Requires SEND_PWM_BY_TIMER or USE_NO_SEND_PWM.
+ */
+//#define ENABLE_IR_REPEATER
+
+/**
+ * Define to enable the table driven translation of received codes, see IRBridge.hpp.
+ */
+//#define ENABLE_IR_BRIDGE
+#if defined(ENABLE_IR_BRIDGE)
+#  if !defined(IR_BRIDGE_HASH_TABLE_SIZE)
+#define IR_BRIDGE_HASH_TABLE_SIZE   64 // Must be a power of 2 and greater than the number of table entries. Requires 1 byte of RAM per entry.
+#  endif
+#  if !defined(IR_BRIDGE_QUEUE_SIZE)
+#define IR_BRIDGE_QUEUE_SIZE        4 // One entry is always free, so this can hold 3 outputs
+#  endif
+#  if !defined(IR_BRIDGE_RAW_FREQUENCY_KHZ)
+#define IR_BRIDGE_RAW_FREQUENCY_KHZ 38
+#  endif
+#endif
+
+/**
+ * Define to enable IrSender.sendBytecode() and IrSender.sendBytecode_P() for protocols described by bytecode, see IRBytecode.hpp.
+ */
+//#define ENABLE_IR_BYTECODE
+
+/**
+ * Define to enable IrSender.startRepeat(), IrSender.handleRepeat() and IrSender.stopRepeat() for sending held keys, see IRSendHeldKey.hpp.
+ */
+//#define ENABLE_IR_HELD_KEY
+
+/**
+ * Define to enable IrReceiver.setAddressFilter(), see IRAddressFilter.hpp.
+ */
+//#define ENABLE_ADDRESS_FILTER
+
+/**
+ * Define to enable IrReceiver.feedDuration() and IrReceiver.feedPCMSample() for decoding recordings, see IRFeed.hpp.
+ */
+//#define ENABLE_IR_FEED
+
+/**
+ * Define to enable printIRResultAsVCD(), printRawMicrosAsVCD() and IrReceiver.feedVCDCharacter(), see IRVCD.hpp.
+ */
+//#define ENABLE_IR_VCD
+#if defined(ENABLE_IR_VCD) && !defined(ENABLE_IR_FEED)
+#define ENABLE_IR_FEED
+#endif
+
+/**
+ * Define to enable IrReceiver.feedSampledBits() for receiving from a bit stream sampled with a high rate, see IRSPICapture.hpp.
+ * For the RP2040, IrReceiver.startSPICapture() samples the receiver output continuously by SPI and DMA.
+ */
+//#define ENABLE_IR_SPI_CAPTURE
+#if defined(ENABLE_IR_SPI_CAPTURE)
+#  if !defined(ENABLE_IR_FEED)
+#define ENABLE_IR_FEED
+#  endif
+#  if !defined(IR_CAPTURE_SAMPLE_RATE)
+#define IR_CAPTURE_SAMPLE_RATE              1000000 // 1 us resolution
+#  endif
+#  if !defined(IR_CAPTURE_RING_BUFFER_SIZE_LOG2)
+#define IR_CAPTURE_RING_BUFFER_SIZE_LOG2    10 // 1024 words of 16 samples = 16 ms at 1 MHz. Maximum is 14.
+#  endif
+#define IR_CAPTURE_RING_BUFFER_SIZE         (1 << IR_CAPTURE_RING_BUFFER_SIZE_LOG2)
+#endif
+
+/**
+ * Define to enable runIRSelfTest(), which sends all enabled protocols to the coupled receiver, see IRSelfTest.hpp.
+ */
+//#define ENABLE_IR_SELF_TEST
+#if defined(ENABLE_IR_SELF_TEST) && !defined(ENABLE_IR_SEND_RECORDER)
+#define ENABLE_IR_SEND_RECORDER
+#endif
+
+/**
+ * Define to enable IrSender.startRecording() and IrSender.printRecording() for measuring the timing error
+ * of each sent mark and space and the encoding cost of the send functions, see IRSendRecorder.hpp.
+ */
+//#define ENABLE_IR_SEND_RECORDER
+#if defined(ENABLE_IR_SEND_RECORDER) && !defined(IR_SEND_RECORDER_SIZE)
+#define IR_SEND_RECORDER_SIZE 100 // Requires 4.125 bytes per interval. 100 is sufficient for one frame of all protocols except Pronto and sendRaw() data
+#endif
+
+/**
+ * Define to let IrSender.begin() measure the overheads of the software PWM and of the delays with IrSender.calibrateSendTiming().
+ * The measured values replace PULSE_CORRECTION_NANOS and the empirical constants, which are only valid for a 16 MHz AVR.
+ */
+//#define ENABLE_IR_SEND_CALIBRATION
+
+/**
+ * Define to run receiving, decoding and sending on core 1 of the RP2040, see IRCore1Engine.hpp.
+ * Sending uses software PWM by default, since core 1 is not disturbed by the application.
+ */
+//#define ENABLE_IR_CORE1_ENGINE
+#if defined(ENABLE_IR_CORE1_ENGINE)
+#  if !defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_ARCH_MBED)
+#error ENABLE_IR_CORE1_ENGINE is only supported for the arduino-pico core
+#  endif
+#  if !defined(ENABLE_IR_PIPELINE)
+#define ENABLE_IR_PIPELINE
+#  endif
+#  if !defined(IR_CORE1_SEND_QUEUE_SIZE)
+#define IR_CORE1_SEND_QUEUE_SIZE 4 // One entry is always free, so this can hold 3 requests
+#  endif
+#  if !defined(IR_CORE1_ALARM_POOL_SIZE)
+#define IR_CORE1_ALARM_POOL_SIZE 1 // Only the receive timer uses this pool
+#  endif
+//#define IR_CORE1_HARDWARE_ALARM_NUMBER 2 // Define to use a fixed hardware alarm for the pool. By default, an unused alarm is claimed.
+#endif
+
+/**
+ * Define to let the ISR copy each received frame into a ring of raw frames and restart receiving immediately.
+ * The frames are decoded by runIRPipeline() or by the task started with startIRPipelineTask(), see IRPipeline.hpp.
+ * Results are read by IrReceiver.read(), so ENABLE_IR_RESULT_FIFO is enabled too.
+ */
+//#define ENABLE_IR_PIPELINE
+#if defined(ENABLE_IR_PIPELINE)
+#  if !defined(ENABLE_IR_RESULT_FIFO)
+#define ENABLE_IR_RESULT_FIFO
+#  endif
+#  if !defined(IR_PIPELINE_NUMBER_OF_FRAMES)
+#define IR_PIPELINE_NUMBER_OF_FRAMES 3 // Each frame requires RAW_BUFFER_LENGTH * 2 bytes of RAM. One entry is always free, so this can hold 2 frames
+#  endif
+#  if !defined(IR_PIPELINE_TASK_STACK_SIZE)
+#define IR_PIPELINE_TASK_STACK_SIZE 3072 // In bytes
+#  endif
+#  if !defined(IR_PIPELINE_TASK_PRIORITY)
+#define IR_PIPELINE_TASK_PRIORITY 2 // FreeRTOS priority, loop() runs with 1 on ESP32
+#  endif
+#  if defined(USE_NON_DEMODULATING_RECEIVER)
+#error ENABLE_IR_PIPELINE is not supported for USE_NON_DEMODULATING_RECEIVER
+#  endif
+#endif
+
+/**
+ * Define to decode in the background by decodeToResultFifo() and to get the results from a FIFO by IrReceiver.read().
+ */
+//#define ENABLE_IR_RESULT_FIFO
+#if defined(ENABLE_IR_RESULT_FIFO)
+#  if !defined(IR_RESULT_FIFO_SIZE)
+#define IR_RESULT_FIFO_SIZE 4 // One entry is always free, so this can hold 3 results
+#  endif
+#  if defined(USE_NON_DEMODULATING_RECEIVER)
+#error ENABLE_IR_RESULT_FIFO is not supported for USE_NON_DEMODULATING_RECEIVER, since the end of a frame is only detected by polling
+#  endif
+#endif
+
 /** Minimum gap between IR transmissions, in MICROS_PER_TICK */
 #define RECORD_GAP_TICKS    (RECORD_GAP_MICROS / MICROS_PER_TICK) // 100
 
@@ -192,7 +421,7 @@
  */
 //#define SEND_PWM_BY_TIMER // restricts send pin on many platforms to fixed pin numbers
 #if (defined(ESP32) || defined(ARDUINO_ARCH_RP2040) || defined(PARTICLE)) || defined(ARDUINO_ARCH_MBED)
-#  if !defined(SEND_PWM_BY_TIMER)
+#  if !defined(SEND_PWM_BY_TIMER) && !defined(ENABLE_IR_CORE1_ENGINE) && !defined(SEND_PWM_BY_SPI)
 #define SEND_PWM_BY_TIMER       // the best and default method for ESP32 etc.
 #warning INFO: For ESP32, RP2040, mbed and particle boards SEND_PWM_BY_TIMER is enabled by default. If this is not intended, deactivate the line in IRremote.hpp over this warning message in file IRremote.hpp.
 #  endif
@@ -215,6 +444,27 @@
 #undef SEND_PWM_BY_TIMER // USE_NO_SEND_PWM overrides SEND_PWM_BY_TIMER
 #endif
 
+/**
+ * Define to generate the carrier as bit pattern at the MOSI pin of the SPI hardware, see IRSendSPI.hpp.
+ * The carrier is not disturbed by interrupts and no PWM timer pin is required. The send pin given at begin() is not used.
+ */
+//#define SEND_PWM_BY_SPI
+#if defined(SEND_PWM_BY_SPI)
+#  if defined(SEND_PWM_BY_TIMER) || defined(USE_NO_SEND_PWM)
+#error SEND_PWM_BY_SPI cannot be combined with SEND_PWM_BY_TIMER or USE_NO_SEND_PWM
+#  endif
+#  if !defined(ESP32) && !defined(ESP8266) && !(defined(ARDUINO_ARCH_RP2040) && !defined(ARDUINO_ARCH_MBED))
+// Single byte transfers have gaps between the bytes, which stretch the marks by 10 to 30 percent and disturb the carrier
+#error SEND_PWM_BY_SPI requires the SPI block write of the ESP32, ESP8266 or arduino-pico core
+#  endif
+#  if !defined(IR_SPI_BIT_RATE)
+#define IR_SPI_BIT_RATE     1000000 // Must be a SPI clock, which the board can generate exactly, e.g. 80 MHz / 80 for ESP32
+#  endif
+#  if !defined(IR_SPI_PATTERN_SIZE)
+#define IR_SPI_PATTERN_SIZE 125 // 1000 bits, which is an integer number of periods for all integer kHz frequencies at 1 MHz bit rate
+#  endif
+#endif
+
 /**
  * Define to use or simulate open drain output mode at send pin.
  * Attention, active state of open drain is LOW, so connect the send LED between positive supply and send pin!
@@ -283,8 +533,47 @@
 #include "IRProtocol.hpp" // must be first, it includes definition for PrintULL (unsigned long long)
 #if !defined(DISABLE_CODE_FOR_RECEIVER)
 #include "IRReceive.hpp"
+#  if defined(USE_NON_DEMODULATING_RECEIVER)
+#include "IRCarrierMeasurement.hpp"
+#  endif
+#  if defined(ENABLE_IR_LEARNING)
+#include "IRLearning.hpp"
+#  endif
+#  if defined(ENABLE_IR_PIPELINE)
+#include "IRPipeline.hpp"
+#  endif
+#  if defined(ENABLE_IR_FEED)
+#include "IRFeed.hpp"
+#  endif
+#  if defined(ENABLE_IR_VCD)
+#include "IRVCD.hpp"
+#  endif
+#  if defined(ENABLE_IR_SPI_CAPTURE)
+#include "IRSPICapture.hpp"
+#  endif
+#  if defined(ENABLE_IR_CORE1_ENGINE)
+#include "IRCore1Engine.hpp"
+#  endif
+#endif
+#if defined(SEND_PWM_BY_SPI)
+#include "IRSendSPI.hpp"
 #endif
 #include "IRSend.hpp"
+#if defined(ENABLE_IR_SEND_RECORDER)
+#include "IRSendRecorder.hpp"
+#endif
+#if defined(ENABLE_IR_SELF_TEST) && !defined(DISABLE_CODE_FOR_RECEIVER)
+#include "IRSelfTest.hpp"
+#endif
+#if defined(ENABLE_IR_REPEATER) && !defined(DISABLE_CODE_FOR_RECEIVER)
+#include "IRRepeater.hpp"
+#endif
+#if defined(ENABLE_IR_BRIDGE) && !defined(DISABLE_CODE_FOR_RECEIVER)
+#include "IRBridge.hpp"
+#endif
+#if defined(ENABLE_IR_BYTECODE)
+#include "IRBytecode.hpp"
+#endif
 
 /*
  * Include the sources of all decoders here to enable compilation with macro values set by user program.
@@ -305,7 +594,16 @@
 #include "ir_CDTV.hpp"
 #include "ir_RC5_CDI.hpp"
 #include "ir_Others.hpp"
+#  if defined(DECODE_DESCRIPTOR) // Decoding and sending with descriptors
+#include "ir_Descriptor.hpp"
+#  endif
 #include "ir_Pronto.hpp" // pronto is an universal decoder and encoder
+#  if defined(ENABLE_IR_HELD_KEY)
+#include "IRSendHeldKey.hpp"
+#  endif
+#  if defined(ENABLE_ADDRESS_FILTER) && !defined(DISABLE_CODE_FOR_RECEIVER)
+#include "IRAddressFilter.hpp"
+#  endif
 #  if defined(DECODE_DISTANCE_WIDTH)     // universal decoder for pulse distance width protocols - requires up to 750 bytes additional program memory
 #include <ir_DistanceWidthProtocol.hpp>
 #  endif
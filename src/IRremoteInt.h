@@ -88,9 +88,23 @@
 #define IR_REC_STATE_SPACE     2 // A space was received and we are counting the duration of it. If space is too long, we assume end of frame.
 #define IR_REC_STATE_STOP      3 // Stopped until set to IR_REC_STATE_IDLE which can only be done by resume()
 
+/*
+ * Ownership of the raw buffer is passed by StateForISR. In state IR_REC_STATE_STOP it is owned by decode(), else by the ISR.
+ * On dual core CPUs the ISR can run on another core than decode(), so volatile is not sufficient to make the buffer content visible
+ * to the new owner. The state (and the ring indexes of the FIFOs) must therefore be written with release and read with acquire semantic.
+ */
+#if defined(ESP32) || defined(ARDUINO_ARCH_RP2040)
+#define IR_LOAD_ACQUIRE(aVariable)          __atomic_load_n(&(aVariable), __ATOMIC_ACQUIRE)
+#define IR_STORE_RELEASE(aVariable, aValue) __atomic_store_n(&(aVariable), (aValue), __ATOMIC_RELEASE)
+#else
+#define IR_LOAD_ACQUIRE(aVariable)          (aVariable)
+#define IR_STORE_RELEASE(aVariable, aValue) ((aVariable) = (aValue))
+#endif
+
 /**
  * This struct contains the data and control used for receiver static functions and the ISR (interrupt service routine)
  * Only StateForISR needs to be volatile. All the other fields are not written by ISR after data available and before start/resume.
+ * StateForISR is accessed with IR_LOAD_ACQUIRE() and IR_STORE_RELEASE() at the points where the ownership of the raw buffer changes.
  */
 struct irparams_struct {
     // The fields are ordered to reduce memory over caused by struct-padding
@@ -170,6 +184,27 @@ struct decode_results {
     bool overflow;              // deprecated, moved to decodedIRData.flags ///< true if IR raw code too long
 };
 
+#if defined(ENABLE_IR_REPEATER)
+/**
+ * Filter for IrReceiver.startRepeater(). Gets the ticks of the first mark of a frame and returns true if the frame is to be forwarded.
+ */
+typedef bool (*IRRepeaterFilterFunctionPointer)(uint16_t aHeaderMarkTicks);
+void handleRepeaterTick(bool aInputIsMark);
+#endif
+
+#if defined(ENABLE_USER_DECODERS)
+/**
+ * Signature of a user decoder registered by IrReceiver.registerDecoder().
+ * The decoder reads aIRDataPtr->rawDataPtr->rawbuf[] and must fill protocol, address, command etc. of *aIRDataPtr if it returns true.
+ */
+typedef bool (*IRUserDecoderFunctionPointer)(IRData *aIRDataPtr);
+/*
+ * User decoders with a priority below this value are called before the built-in decoders,
+ * all others are called after the built-in decoders, but before the universal decoder.
+ */
+#define IR_DECODER_PRIORITY_BUILTIN 100
+#endif
+
 /**
  * Main class for receiving IR signals
  */
@@ -180,7 +215,12 @@ public:
     IRrecv(uint_fast8_t aReceivePin);
     IRrecv(uint_fast8_t aReceivePin, uint_fast8_t aFeedbackLEDPin);
     void setReceivePin(uint_fast8_t aReceivePinNumber);
+#if defined(USE_NON_DEMODULATING_RECEIVER)
+    // The end of a frame is only detected by polling, so the callback would never be called
+    void registerReceiveCompleteCallback(void (*aReceiveCompleteCallbackFunction)(void)) = delete;
+#else
     void registerReceiveCompleteCallback(void (*aReceiveCompleteCallbackFunction)(void));
+#endif
     /*
      * Stream like API
      */
@@ -232,7 +272,93 @@ public:
 #endif
     static void printActiveIRProtocols(Print *aSerial);
 
+#if defined(USE_NON_DEMODULATING_RECEIVER)
+    /*
+     * Carrier measurement for learning, see IRCarrierMeasurement.hpp
+     */
+    void checkForEndOfCarrierFrame();
+    uint32_t getCarrierFrequencyHertz();
+    uint_fast8_t getCarrierFrequencyKHz();
+    uint8_t getCarrierDutyCyclePercent();
+    void printCarrierInfo(Print *aSerial);
+#endif
+
+#if defined(ENABLE_IR_REPEATER)
+    /*
+     * Cut-through repeater, see IRRepeater.hpp
+     */
+    void startRepeater(uint8_t aDelayTicks, uint_fast8_t aFrequencyKHz, IRRepeaterFilterFunctionPointer aFilterFunction = NULL);
+    void stopRepeater();
+#endif
+
+#if defined(ENABLE_ADDRESS_FILTER)
+    /*
+     * Address allow-list, see IRAddressFilter.hpp
+     */
+    void setAddressFilter(const uint16_t *aAllowedAddresses, uint8_t aNumberOfAllowedAddresses);
+    bool isFilteredByAddress();
+#endif
+
+#if defined(ENABLE_USER_DECODERS)
+    /*
+     * Registration of user decoders
+     */
+    bool registerDecoder(IRUserDecoderFunctionPointer aDecoderFunction, uint8_t aPriority, uint16_t aHeaderMarkMicros = 0);
+    bool unregisterDecoder(IRUserDecoderFunctionPointer aDecoderFunction);
+    bool decodeWithUserDecoders(uint8_t aMinimumPriority, uint8_t aMaximumPriority);
+#endif
+
+#if defined(ENABLE_IR_FEED)
+    /*
+     * Receiving from recorded durations or PCM samples, see IRFeed.hpp
+     */
+    bool feedDuration(bool aIsMark, uint32_t aDurationMicros);
+    void setPCMFeedParameters(uint32_t aSampleRateHertz, int16_t aLowThreshold, int16_t aHighThreshold, bool aMarkIsLow = true);
+    bool feedPCMSample(int16_t aSample);
+#endif
+
+#if defined(ENABLE_IR_VCD)
+    /*
+     * Logic analyzer export and import, see IRVCD.hpp
+     */
+    void printIRResultAsVCD(Print *aSerial);
+    void startVCDImport(bool aMarkIsLow = true, const char *aSignalName = NULL);
+    bool feedVCDCharacter(char aCharacter);
+#endif
+
+#if defined(ENABLE_IR_SPI_CAPTURE)
+    /*
+     * Receiving from a bit stream sampled with a high rate, see IRSPICapture.hpp
+     */
+    void setSampledBitsParameters(uint32_t aSampleRateHertz, bool aMarkIsLow = true);
+    bool feedSampledBits(const uint16_t *aWords, uint16_t aNumberOfWords);
+#  if defined(ARDUINO_ARCH_RP2040)
+    bool startSPICapture(uint_fast8_t aMISOPin, bool aMarkIsLow = true);
+    void stopSPICapture();
+    bool pollSPICapture();
+#  endif
+#endif
+
+#if defined(ENABLE_IR_SELF_TEST)
+    /*
+     * Receive correction measured by the loopback self test, see IRSelfTest.hpp
+     */
+    void setReceiveCorrection(int16_t aMarkExcessMicros, int16_t aSpaceShorteningMicros);
+    void applyReceiveCorrection();
+#endif
+
+#if defined(ENABLE_IR_LEARNING)
+    /*
+     * Learning from multiple captures, see IRLearning.hpp
+     */
+    void startLearning();
+    uint8_t addCaptureForLearning();
+    uint_fast16_t computeLearnedTicks(uint8_t *aArrayPtr);
+    void printLearnedTicksAsCArray(Print *aSerial, uint8_t *aArrayPtr);
+#endif
+
     void compensateAndPrintIRResultAsCArray(Print *aSerial, bool aOutputMicrosecondsInsteadOfTicks = true);
+    void compensateAndPrintIRResultAsCompressedCArray(Print *aSerial);
     void compensateAndPrintIRResultAsPronto(Print *aSerial, uint16_t frequency = 38000U);
 
     /*
@@ -280,6 +406,19 @@ public:
 
     bool decodeDistanceWidth();
 
+    /*
+     * Generic decoder for protocols described by an IRProtocolDescriptor, see ir_Descriptor.hpp
+     */
+    void setDescriptorTable_P(IRProtocolDescriptor const *aDescriptorTablePGM, uint8_t aNumberOfDescriptors);
+    bool decodeDescriptors();
+    bool decodeWithDescriptor(IRProtocolDescriptor *aDescriptor);
+    bool decodeBiphaseWithDescriptor(IRProtocolDescriptor *aDescriptor, IRRawDataType *aDecodedDataPtr);
+#if defined(ENABLE_DESCRIPTOR_LOADING)
+    bool loadDescriptor(const uint8_t *aSerializedDescriptor, uint8_t (*aReadByteFunction)(const uint8_t *aBytePtr));
+    bool loadDescriptor_P(const uint8_t *aSerializedDescriptorPGM);
+    void clearLoadedDescriptors();
+#endif
+
     bool decodeHash();
 
     // Template function :-)
@@ -324,10 +463,26 @@ public:
     uint32_t lastDecodedCommand;
 
     uint8_t repeatCount;        // Used e.g. for Denon decode for autorepeat decoding.
+    uint8_t decodedDescriptorIndex; // Index of the descriptor in the table set by setDescriptorTable_P() which matched the last frame
+
+    // State of getBiphaselevel(). Members instead of globals, so that each IRrecv instance can decode independently.
+    uint_fast8_t biphaseDecodeRawbuffOffset; // Index into raw timing array
+    uint16_t biphaseCurrentTimingIntervals; // 1, 2 or 3. Number of biphaseTimeUnit intervals of the current rawbuf[biphaseDecodeRawbuffOffset] timing.
+    uint_fast8_t biphaseUsedTimingIntervals; // Number of already used intervals of biphaseCurrentTimingIntervals.
+    uint16_t biphaseTimeUnit;
+#if defined(ENABLE_IR_RESULT_FIFO)
+    uint16_t numberOfLostResults; // Number of results not stored by decodeToResultFifo(), because the FIFO was full
+#endif
+#if defined(ENABLE_ADDRESS_FILTER)
+    uint16_t numberOfFilteredFrames; // Number of frames dropped by the address filter since setAddressFilter()
+#endif
+#if defined(ENABLE_IR_SELF_TEST)
+    int8_t markCorrectionTicks; // Subtracted from all marks before decoding, set by setReceiveCorrection()
+    int8_t spaceCorrectionTicks; // Added to all spaces before decoding
+    bool receiveCorrectionIsApplied; // Set by applyReceiveCorrection() and reset by resume(), to correct each frame only once
+#endif
 };
 
-extern uint_fast8_t sBiphaseDecodeRawbuffOffset; //
-
 /*
  * Mark & Space matching functions
  */
@@ -395,11 +550,29 @@ void setBlinkPin(uint8_t aFeedbackLEDPin) __attribute__ ((deprecated ("Please us
  * The receiver instance
  */
 extern IRrecv IrReceiver;
+#if defined(ENABLE_IR_RESULT_FIFO)
+void decodeToResultFifo();
+#endif
+#if defined(ENABLE_IR_VCD)
+void printRawMicrosAsVCD(Print *aSerial, const uint16_t aBufferWithMicroseconds[], uint_fast16_t aLengthOfBuffer);
+#endif
+#if defined(ENABLE_IR_PIPELINE)
+void runIRPipeline();
+bool startIRPipelineTask();
+#endif
 
 /*
  * The receiver interrupt handler for timer interrupt
  */
 void IRReceiveTimerInterruptHandler();
+#if defined(USE_NON_DEMODULATING_RECEIVER)
+/*
+ * The receiver interrupt handler for edge interrupts of a non demodulating receiver
+ */
+void IRCarrierEdgeInterruptHandler();
+void enableCarrierEdgeInterrupt();
+void disableCarrierEdgeInterrupt();
+#endif
 
 /****************************************************
  *                     SENDING
@@ -440,6 +613,25 @@ public:
     size_t write(IRData *aIRSendData, int_fast8_t aNumberOfRepeats = NO_REPEATS);
     size_t write(decode_type_t aProtocol, uint16_t aAddress, uint16_t aCommand, int_fast8_t aNumberOfRepeats = NO_REPEATS);
 
+#if defined(ENABLE_IR_HELD_KEY)
+    /*
+     * Non blocking sending of a held key, see IRSendHeldKey.hpp
+     */
+    void startRepeat(decode_type_t aProtocol, uint16_t aAddress, uint16_t aCommand);
+    bool handleRepeat();
+    void stopRepeat();
+    bool isRepeating();
+#endif
+
+#if defined(ENABLE_IR_SEND_RECORDER)
+    /*
+     * Recording of sent intervals for timing analysis, see IRSendRecorder.hpp
+     */
+    void startRecording(bool aDryRun = false);
+    void stopRecording();
+    void printRecording(Print *aSerial);
+#endif
+
     void enableIROut(uint_fast8_t aFrequencyKHz);
 #if defined(SEND_PWM_BY_TIMER)
     void enableHighFrequencyIROut(uint_fast16_t aFrequencyKHz); // Used for Bang&Olufsen
@@ -462,6 +654,10 @@ public:
 
     void sendPulseDistanceWidth(PulseDistanceWidthProtocolConstants *aProtocolConstants, IRRawDataType aData,
             uint_fast8_t aNumberOfBits, int_fast8_t aNumberOfRepeats);
+    void sendPulseDistanceWidth_P(PulseDistanceWidthProtocolConstants const *aProtocolConstantsPGM, IRRawDataType aData,
+            uint_fast8_t aNumberOfBits, int_fast8_t aNumberOfRepeats);
+    void sendPulseDistanceWidthFromArray_P(PulseDistanceWidthProtocolConstants const *aProtocolConstantsPGM,
+            IRRawDataType const *aDecodedRawDataArrayPGM, uint16_t aNumberOfBits, int_fast8_t aNumberOfRepeats);
     void sendPulseDistanceWidthData(PulseDistanceWidthProtocolConstants *aProtocolConstants, IRRawDataType aData,
             uint_fast8_t aNumberOfBits);
     void sendPulseDistanceWidth(uint_fast8_t aFrequencyKHz, uint16_t aHeaderMarkMicros, uint16_t aHeaderSpaceMicros,
@@ -492,6 +688,19 @@ public:
     void sendRaw(const uint16_t aBufferWithMicroseconds[], uint_fast16_t aLengthOfBuffer, uint_fast8_t aIRFrequencyKilohertz);
     void sendRaw_P(const uint16_t aBufferWithMicroseconds[], uint_fast16_t aLengthOfBuffer, uint_fast8_t aIRFrequencyKilohertz);
 
+// Compressed array with symbol dictionary
+    void sendRawCompressed_P(const uint8_t aCompressedBuffer[], uint_fast8_t aIRFrequencyKilohertz);
+
+#if defined(ENABLE_IR_BYTECODE)
+// Bytecode interpreter, see IRBytecode.hpp
+    bool sendBytecode(const uint8_t *aBytecode, uint16_t aBytecodeLength, uint16_t aAddress, uint16_t aCommand,
+            int_fast8_t aNumberOfRepeats);
+    bool sendBytecode_P(const uint8_t *aBytecodePGM, uint16_t aBytecodeLength, uint16_t aAddress, uint16_t aCommand,
+            int_fast8_t aNumberOfRepeats);
+    bool sendBytecode(const uint8_t *aBytecode, uint16_t aBytecodeLength, uint8_t (*aReadByteFunction)(const uint8_t *aBytePtr),
+            uint16_t aAddress, uint16_t aCommand, int_fast8_t aNumberOfRepeats);
+#endif
+
     /*
      * New send functions
      */
@@ -542,6 +751,9 @@ public:
     void sendSharp(uint8_t aAddress, uint8_t aCommand, int_fast8_t aNumberOfRepeats); // redirected to sendDenon
     void sendSony(uint16_t aAddress, uint8_t aCommand, int_fast8_t aNumberOfRepeats, uint8_t numberOfBits = 12); // SIRCS_12_PROTOCOL
 
+    void sendWithDescriptor(IRProtocolDescriptor *aDescriptor, uint16_t aAddress, uint16_t aCommand, int_fast8_t aNumberOfRepeats);
+    void sendWithDescriptor_P(IRProtocolDescriptor const *aDescriptorPGM, uint16_t aAddress, uint16_t aCommand,
+            int_fast8_t aNumberOfRepeats);
     void sendLegoPowerFunctions(uint8_t aChannel, uint8_t tCommand, uint8_t aMode, bool aDoSend5Times = true);
     void sendLegoPowerFunctions(uint16_t aRawData, bool aDoSend5Times = true);
     void sendLegoPowerFunctions(uint16_t aRawData, uint8_t aChannel, bool aDoSend5Times = true);
@@ -610,6 +822,13 @@ public:
     uint16_t periodOnTimeMicros; // compensated with PULSE_CORRECTION_NANOS for duration of digitalWrite. Around 8 microseconds for 38 kHz.
     uint16_t getPulseCorrectionNanos();
 
+#if defined(ENABLE_IR_SEND_CALIBRATION)
+    void calibrateSendTiming();
+    uint16_t pulseCorrectionNanos; // Measured replacement for PULSE_CORRECTION_NANOS
+    uint8_t markEndCorrectionMicros; // Measured replacement for the empirical 112 / CLOCKS_PER_MICRO of mark()
+    static uint8_t delayCorrectionMicros; // Measured replacement for the empirical 64 / clockCyclesPerMicrosecond() of customDelayMicroseconds()
+#endif
+
     static void customDelayMicroseconds(unsigned long aMicroseconds);
 };
 
@@ -617,6 +836,41 @@ public:
  * The sender instance
  */
 extern IRsend IrSender;
+#if defined(ENABLE_IR_HELD_KEY)
+uint16_t getRepeatPeriodMillis(decode_type_t aProtocol);
+#endif
+#if defined(ENABLE_IR_SEND_RECORDER)
+bool recordSendInterval(bool aIsMark, uint16_t aMicros);
+#endif
+#if defined(ENABLE_IR_SELF_TEST)
+struct IRSelfTestReportStruct;
+bool runIRSelfTest(IRSelfTestReportStruct *aReport, uint8_t aNumberOfFramesPerProtocol = 3, bool aApplyCorrection = true);
+void printIRSelfTestReport(IRSelfTestReportStruct *aReport, Print *aSerial);
+#endif
+#if defined(ENABLE_IR_CORE1_ENGINE)
+bool setupIREngineOnCore1(uint_fast8_t aReceivePin);
+void loopIREngineOnCore1();
+bool sendOnCore1(decode_type_t aProtocol, uint16_t aAddress, uint16_t aCommand, int_fast8_t aNumberOfRepeats = NO_REPEATS);
+#endif
+
+#if defined(ENABLE_IR_BRIDGE)
+/**
+ * Entry of the mapping table for the bridge, see IRBridge.hpp
+ */
+struct IRBridgeEntry {
+    decode_type_t InputProtocol;
+    uint16_t InputAddress;
+    uint16_t InputCommand;
+    decode_type_t OutputProtocol;   ///< If UNKNOWN, OutputCompressedRawPGM is sent with IR_BRIDGE_RAW_FREQUENCY_KHZ
+    uint16_t OutputAddress;
+    uint16_t OutputCommand;
+    const uint8_t *OutputCompressedRawPGM; ///< Data in FLASH in the format of sendRawCompressed_P()
+};
+bool setBridgeTable_P(IRBridgeEntry const *aBridgeTablePGM, uint8_t aNumberOfEntries);
+int_fast16_t findBridgeEntry(decode_type_t aProtocol, uint16_t aAddress, uint16_t aCommand);
+bool queueBridgeOutput(IRData *aIRReceivedData);
+bool serviceBridge();
+#endif
 
 void sendNECSpecialRepeat();
 void sendLG2SpecialRepeat();
@@ -0,0 +1,499 @@
+/*
+ * ir_Descriptor.hpp
+ *
+ *  Contains the generic decoder and encoder for pulse distance and pulse width protocols described by an IRProtocolDescriptor.
+ *  Descriptors are the output of a converter from IRP notation and are evaluated with precomputed tick windows,
+ *  so new protocols can be decoded at the speed of the built-in decoders without writing an ir_*.hpp file.
+ *
+ *  This file is part of Arduino-IRremote https://github.com/Arduino-IRremote/Arduino-IRremote.
+ *
+ ************************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 Armin Joachimsmeyer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ************************************************************************************
+ */
+#ifndef _IR_DESCRIPTOR_HPP
+#define _IR_DESCRIPTOR_HPP
+
+#if defined(DEBUG) && !defined(LOCAL_DEBUG)
+#define LOCAL_DEBUG
+#else
+//#define LOCAL_DEBUG // This enables debug output only for this file
+#endif
+
+/** \addtogroup Decoder Decoders and encoders for different protocols
+ * @{
+ */
+//==============================================================================
+//     DDDD   EEEEE   SSSS   CCCC  RRRR   IIIII  PPPP   TTTTT   OOO   RRRR
+//     D   D  E      S      C      R   R    I    P   P    T    O   O  R   R
+//     D   D  EEE     SSS   C      RRRR     I    PPPP     T    O   O  RRRR
+//     D   D  E          S  C      R  R     I    P        T    O   O  R  R
+//     DDDD   EEEEE  SSSS    CCCC  R   R  IIIII  P        T     OOO   R   R
+//==============================================================================
+/*
+ * Example descriptor for NEC {38k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,^108m)
+ *
+ * const IRProtocolDescriptor NECDescriptor PROGMEM = { { NEC, 38, { 9000, 4500, 560, 1690, 560, 560 }, PROTOCOL_IS_LSB_FIRST, 110, NULL },
+ *      32, 16, 8, IR_DESCRIPTOR_FLAGS_EXTRA_IS_INVERTED_COMMAND, IR_DESCRIPTOR_TICK_WINDOWS(9000, 4500, 560, 1690, 560, 560),
+ *      2250, IR_SPACE_TICK_WINDOW(2250) };
+ * IrReceiver.setDescriptorTable_P(&NECDescriptor, 1);
+ *
+ * The same descriptor serialized for EEPROM, to be loaded at runtime by IrReceiver.loadDescriptor():
+ * const uint8_t NECSerializedDescriptor[IR_SERIALIZED_DESCRIPTOR_SIZE] = { NEC, 38, IR_BYTECODE_16(9000), IR_BYTECODE_16(4500),
+ *      IR_BYTECODE_16(560), IR_BYTECODE_16(1690), IR_BYTECODE_16(560), IR_BYTECODE_16(560), PROTOCOL_IS_LSB_FIRST, IR_BYTECODE_16(110),
+ *      32, 16, 8, IR_DESCRIPTOR_FLAGS_EXTRA_IS_INVERTED_COMMAND, IR_BYTECODE_16(2250) };
+ */
+
+IRProtocolDescriptor const *sDescriptorTablePGM; // The descriptors tried by decodeDescriptors()
+uint8_t sNumberOfDescriptors;
+#if defined(ENABLE_DESCRIPTOR_LOADING)
+IRProtocolDescriptor sLoadedDescriptors[IR_NUMBER_OF_LOADABLE_DESCRIPTORS]; // The descriptors loaded at runtime, tried after the table
+uint8_t sNumberOfLoadedDescriptors;
+#endif
+
+static void computeTickWindow(IRTickWindow *aTickWindow, uint16_t aCompensatedMicros) {
+    aTickWindow->MinTicks = TICKS_LOW(aCompensatedMicros);
+    aTickWindow->MaxTicks = TICKS_HIGH(aCompensatedMicros);
+}
+
+/**
+ * Fills the tick windows of the descriptor from its ProtocolConstants and RepeatHeaderSpaceMicros.
+ * Use it for descriptors created at runtime, otherwise use the IR_DESCRIPTOR_TICK_WINDOWS() macro in the initializer.
+ */
+void computeDescriptorTickWindows(IRProtocolDescriptor *aDescriptor) {
+    DistanceWidthTimingInfoStruct *tTimingInfo = &aDescriptor->ProtocolConstants.DistanceWidthTimingInfo;
+    computeTickWindow(&aDescriptor->HeaderMarkTicks, tTimingInfo->HeaderMarkMicros + MARK_EXCESS_MICROS);
+    computeTickWindow(&aDescriptor->HeaderSpaceTicks, tTimingInfo->HeaderSpaceMicros - MARK_EXCESS_MICROS);
+    computeTickWindow(&aDescriptor->OneMarkTicks, tTimingInfo->OneMarkMicros + MARK_EXCESS_MICROS);
+    computeTickWindow(&aDescriptor->OneSpaceTicks, tTimingInfo->OneSpaceMicros - MARK_EXCESS_MICROS);
+    computeTickWindow(&aDescriptor->ZeroMarkTicks, tTimingInfo->ZeroMarkMicros + MARK_EXCESS_MICROS);
+    computeTickWindow(&aDescriptor->ZeroSpaceTicks, tTimingInfo->ZeroSpaceMicros - MARK_EXCESS_MICROS);
+    if (aDescriptor->RepeatHeaderSpaceMicros == 0) {
+        aDescriptor->RepeatHeaderSpaceTicks.MinTicks = 0;
+        aDescriptor->RepeatHeaderSpaceTicks.MaxTicks = 0;
+    } else {
+        computeTickWindow(&aDescriptor->RepeatHeaderSpaceTicks, aDescriptor->RepeatHeaderSpaceMicros - MARK_EXCESS_MICROS);
+    }
+}
+
+/*
+ * The maximum gap between 2 frames of a held key is the repeat period minus the duration of the shortest frame,
+ * plus 10 ms, like NEC_MAXIMUM_REPEAT_DISTANCE.
+ */
+static uint16_t getMaximumRepeatSpaceTicks(IRProtocolDescriptor *aDescriptor) {
+    DistanceWidthTimingInfoStruct *tTimingInfo = &aDescriptor->ProtocolConstants.DistanceWidthTimingInfo;
+    uint32_t tMinimalFrameMicros;
+    if (aDescriptor->DescriptorFlags & IR_DESCRIPTOR_FLAGS_BIPHASE) {
+        tMinimalFrameMicros = (uint32_t) aDescriptor->NumberOfBits * 2 * tTimingInfo->OneMarkMicros;
+    } else {
+        uint16_t tOneMicros = tTimingInfo->OneMarkMicros + tTimingInfo->OneSpaceMicros;
+        uint16_t tZeroMicros = tTimingInfo->ZeroMarkMicros + tTimingInfo->ZeroSpaceMicros;
+        tMinimalFrameMicros = tTimingInfo->HeaderMarkMicros + tTimingInfo->HeaderSpaceMicros
+                + ((uint32_t) aDescriptor->NumberOfBits * ((tOneMicros < tZeroMicros) ? tOneMicros : tZeroMicros))
+                + tTimingInfo->OneMarkMicros;
+    }
+    int32_t tMaximumRepeatSpaceMicros = ((uint32_t) aDescriptor->ProtocolConstants.RepeatPeriodMillis * 1000) - tMinimalFrameMicros
+            + 10000;
+    if (tMaximumRepeatSpaceMicros < 10000) {
+        tMaximumRepeatSpaceMicros = 10000; // RepeatPeriodMillis is too short, but we must accept the usual gap
+    }
+    uint32_t tTicks = tMaximumRepeatSpaceMicros / MICROS_PER_TICK;
+    return (tTicks > UINT16_MAX) ? UINT16_MAX : tTicks;
+}
+
+static bool isInTickWindow(uint16_t aTicks, IRTickWindow *aTickWindow) {
+    return (aTicks >= aTickWindow->MinTicks && aTicks <= aTickWindow->MaxTicks);
+}
+
+/**
+ * Sets the table of descriptors, which are tried by decode() before the universal decoder.
+ * @param aDescriptorTablePGM   Array of descriptors in FLASH (declared with PROGMEM).
+ */
+void IRrecv::setDescriptorTable_P(IRProtocolDescriptor const *aDescriptorTablePGM, uint8_t aNumberOfDescriptors) {
+    sDescriptorTablePGM = aDescriptorTablePGM;
+    sNumberOfDescriptors = aNumberOfDescriptors;
+}
+
+#if defined(ENABLE_DESCRIPTOR_LOADING)
+/**
+ * Loads a serialized descriptor (see IR_SERIALIZED_DESCRIPTOR_SIZE) and computes its tick windows.
+ * This allows to support new remotes on deployed hardware by writing a descriptor to EEPROM.
+ * E.g. for EEPROM use: uint8_t readEEPROM(const uint8_t *aBytePtr) { return EEPROM.read((int) aBytePtr); }
+ * and loadDescriptor((const uint8_t *) EEPROMStartOffset, &readEEPROM)
+ *
+ * @param aSerializedDescriptor Start of the descriptor, which is passed with the offset of the current byte to aReadByteFunction.
+ * @param aReadByteFunction     Function to read one byte of the descriptor.
+ * @return false if IR_NUMBER_OF_LOADABLE_DESCRIPTORS are already loaded or the descriptor is invalid.
+ */
+bool IRrecv::loadDescriptor(const uint8_t *aSerializedDescriptor, uint8_t (*aReadByteFunction)(const uint8_t *aBytePtr)) {
+    if (sNumberOfLoadedDescriptors >= IR_NUMBER_OF_LOADABLE_DESCRIPTORS) {
+        return false;
+    }
+    uint8_t tBytes[IR_SERIALIZED_DESCRIPTOR_SIZE];
+    for (uint_fast8_t i = 0; i < IR_SERIALIZED_DESCRIPTOR_SIZE; i++) {
+        tBytes[i] = aReadByteFunction(aSerializedDescriptor + i);
+    }
+    IRProtocolDescriptor *tDescriptor = &sLoadedDescriptors[sNumberOfLoadedDescriptors];
+    tDescriptor->ProtocolConstants.ProtocolIndex = (decode_type_t) tBytes[0];
+    tDescriptor->ProtocolConstants.FrequencyKHz = tBytes[1];
+    uint16_t *tTimingPtr = &tDescriptor->ProtocolConstants.DistanceWidthTimingInfo.HeaderMarkMicros;
+    for (uint_fast8_t i = 0; i < 6; i++) {
+        tTimingPtr[i] = tBytes[2 + (2 * i)] | (tBytes[3 + (2 * i)] << 8);
+    }
+    tDescriptor->ProtocolConstants.Flags = tBytes[14];
+    tDescriptor->ProtocolConstants.RepeatPeriodMillis = tBytes[15] | (tBytes[16] << 8);
+    tDescriptor->ProtocolConstants.SpecialSendRepeatFunction = NULL;
+    tDescriptor->NumberOfBits = tBytes[17];
+    tDescriptor->NumberOfAddressBits = tBytes[18];
+    tDescriptor->NumberOfCommandBits = tBytes[19];
+    tDescriptor->DescriptorFlags = tBytes[20];
+    tDescriptor->RepeatHeaderSpaceMicros = tBytes[21] | (tBytes[22] << 8);
+
+    uint_fast8_t tNumberOfParityBits = (tDescriptor->DescriptorFlags & (IR_DESCRIPTOR_FLAGS_EVEN_PARITY | IR_DESCRIPTOR_FLAGS_ODD_PARITY)) ? 1 : 0;
+    if (tDescriptor->NumberOfBits == 0 || tDescriptor->NumberOfBits > BITS_IN_RAW_DATA_TYPE
+            || tDescriptor->NumberOfAddressBits > 16 || tDescriptor->NumberOfCommandBits > 16
+            || tDescriptor->NumberOfAddressBits + tDescriptor->NumberOfCommandBits + tNumberOfParityBits > tDescriptor->NumberOfBits) {
+        return false;
+    }
+    // The extra bits are stored in the 16 bit decodedIRData.extra, and sendBiphaseData() sends at most 32 bits
+    uint_fast8_t tNumberOfExtraBits = tDescriptor->NumberOfBits - tNumberOfParityBits - tDescriptor->NumberOfAddressBits
+            - tDescriptor->NumberOfCommandBits;
+    if (tNumberOfExtraBits > 16 || ((tDescriptor->DescriptorFlags & IR_DESCRIPTOR_FLAGS_BIPHASE) && tDescriptor->NumberOfBits > 32)) {
+        return false;
+    }
+    computeDescriptorTickWindows(tDescriptor);
+    sNumberOfLoadedDescriptors++;
+    return true;
+}
+
+/**
+ * Loads a serialized descriptor from FLASH (declared with PROGMEM).
+ */
+bool IRrecv::loadDescriptor_P(const uint8_t *aSerializedDescriptorPGM) {
+    return loadDescriptor(aSerializedDescriptorPGM, &readIRByteFromFlash);
+}
+
+void IRrecv::clearLoadedDescriptors() {
+    sNumberOfLoadedDescriptors = 0;
+}
+#endif // defined(ENABLE_DESCRIPTOR_LOADING)
+
+/**
+ * Tries all descriptors set by setDescriptorTable_P() and then all descriptors loaded by loadDescriptor().
+ * The index of the matching descriptor is stored in decodedDescriptorIndex.
+ * Loaded descriptors have the indexes following the indexes of the table.
+ */
+bool IRrecv::decodeDescriptors() {
+#if defined(LOCAL_DEBUG)
+    unsigned long tStartMicros = micros();
+#endif
+    bool tResult = false;
+    IRProtocolDescriptor tDescriptor;
+    uint_fast8_t i;
+    for (i = 0; i < sNumberOfDescriptors; i++) {
+        memcpy_P(&tDescriptor, &sDescriptorTablePGM[i], sizeof(tDescriptor));
+        if (decodeWithDescriptor(&tDescriptor)) {
+            tResult = true;
+            break;
+        }
+    }
+#if defined(ENABLE_DESCRIPTOR_LOADING)
+    if (!tResult) {
+        for (uint_fast8_t j = 0; j < sNumberOfLoadedDescriptors; j++, i++) {
+            if (decodeWithDescriptor(&sLoadedDescriptors[j])) {
+                tResult = true;
+                break;
+            }
+        }
+    }
+#endif
+    if (tResult) {
+        decodedDescriptorIndex = i;
+    }
+#if defined(LOCAL_DEBUG)
+    Serial.print(F("Descriptor decode took "));
+    Serial.print(micros() - tStartMicros);
+    Serial.println(F(" us"));
+#endif
+    return tResult;
+}
+
+/*
+ * Decodes biphase data like RC5, i.e. start bit, then data MSB first, a space to mark transition is a 1.
+ */
+bool IRrecv::decodeBiphaseWithDescriptor(IRProtocolDescriptor *aDescriptor, IRRawDataType *aDecodedDataPtr) {
+    initBiphaselevel(1, aDescriptor->ProtocolConstants.DistanceWidthTimingInfo.OneMarkMicros); // Skip gap space
+
+    // Check start bit, the first space is included in the gap
+    if (getBiphaselevel() != MARK) {
+        return false;
+    }
+
+    IRRawDataType tDecodedData = 0;
+    uint_fast8_t tBitIndex;
+    for (tBitIndex = 0; biphaseDecodeRawbuffOffset < decodedIRData.rawDataPtr->rawlen; tBitIndex++) {
+        // get next 2 levels and check for transition
+        uint8_t tStartLevel = getBiphaselevel();
+        uint8_t tEndLevel = getBiphaselevel();
+        if ((tStartLevel == SPACE) && (tEndLevel == MARK)) {
+            tDecodedData = (tDecodedData << 1) | 1;
+        } else if ((tStartLevel == MARK) && (tEndLevel == SPACE)) {
+            tDecodedData = (tDecodedData << 1);
+        } else {
+            return false;
+        }
+    }
+    *aDecodedDataPtr = tDecodedData;
+    return (tBitIndex == aDescriptor->NumberOfBits);
+}
+
+/**
+ * Decodes the raw data with the descriptor in RAM.
+ * All marks and spaces are checked against the precomputed tick windows, so no other plausibility check is required.
+ */
+bool IRrecv::decodeWithDescriptor(IRProtocolDescriptor *aDescriptor) {
+    uint_fast8_t tNumberOfBits = aDescriptor->NumberOfBits;
+    auto *tRawBufPointer = &decodedIRData.rawDataPtr->rawbuf[1];
+    bool tIsMSBFirst = (aDescriptor->ProtocolConstants.Flags & PROTOCOL_IS_MSB_FIRST);
+    IRRawDataType tDecodedData = 0;
+
+    if (aDescriptor->DescriptorFlags & IR_DESCRIPTOR_FLAGS_BIPHASE) {
+        tIsMSBFirst = true;
+        if (!decodeBiphaseWithDescriptor(aDescriptor, &tDecodedData)) {
+            return false;
+        }
+
+    } else {
+        /*
+         * Check for repeat frame, consisting of header mark, repeat header space and stop bit
+         */
+        if (decodedIRData.rawDataPtr->rawlen == 4 && aDescriptor->RepeatHeaderSpaceTicks.MaxTicks != 0) {
+            if (isInTickWindow(tRawBufPointer[0], &aDescriptor->HeaderMarkTicks)
+                    && isInTickWindow(tRawBufPointer[1], &aDescriptor->RepeatHeaderSpaceTicks)
+                    && isInTickWindow(tRawBufPointer[2], &aDescriptor->OneMarkTicks)) {
+                decodedIRData.flags = IRDATA_FLAGS_IS_REPEAT | (aDescriptor->ProtocolConstants.Flags & IRDATA_FLAGS_IS_MSB_FIRST);
+                decodedIRData.address = lastDecodedAddress;
+                decodedIRData.command = lastDecodedCommand;
+                decodedIRData.protocol = aDescriptor->ProtocolConstants.ProtocolIndex;
+                return true;
+            }
+            return false;
+        }
+
+        // Check we have the right amount of data. The +4 is for initial gap, start bit mark and space + stop bit mark.
+        if (decodedIRData.rawDataPtr->rawlen != (2 * tNumberOfBits) + 4) {
+            return false;
+        }
+
+        if (!isInTickWindow(tRawBufPointer[0], &aDescriptor->HeaderMarkTicks)
+                || !isInTickWindow(tRawBufPointer[1], &aDescriptor->HeaderSpaceTicks)) {
+            return false;
+        }
+        tRawBufPointer += 2;
+
+        IRRawDataType tMask = 1;
+        for (uint_fast8_t i = 0; i < tNumberOfBits; i++) {
+            uint16_t tMarkTicks = *tRawBufPointer++;
+            uint16_t tSpaceTicks = *tRawBufPointer++;
+            bool tBitValue;
+            if (isInTickWindow(tMarkTicks, &aDescriptor->OneMarkTicks) && isInTickWindow(tSpaceTicks, &aDescriptor->OneSpaceTicks)) {
+                tBitValue = true;
+            } else if (isInTickWindow(tMarkTicks, &aDescriptor->ZeroMarkTicks)
+                    && isInTickWindow(tSpaceTicks, &aDescriptor->ZeroSpaceTicks)) {
+                tBitValue = false;
+            } else {
+#if defined(LOCAL_DEBUG)
+                Serial.print(F("Descriptor: "));
+                Serial.print(F("Bit timing is wrong. Index="));
+                Serial.println(i);
+#endif
+                return false;
+            }
+            if (tIsMSBFirst) {
+                tDecodedData = (tDecodedData << 1) | tBitValue;
+            } else if (tBitValue) {
+                tDecodedData |= tMask;
+            }
+            tMask <<= 1;
+        }
+    }
+
+    /*
+     * Check and remove parity bit, which is the last sent bit
+     */
+    IRRawDataType tValue = tDecodedData;
+    if (aDescriptor->DescriptorFlags & (IR_DESCRIPTOR_FLAGS_EVEN_PARITY | IR_DESCRIPTOR_FLAGS_ODD_PARITY)) {
+        uint_fast8_t tNumberOfOnes = 0;
+        for (IRRawDataType tParityValue = tValue; tParityValue != 0; tParityValue >>= 1) {
+            tNumberOfOnes += tParityValue & 1;
+        }
+        if ((tNumberOfOnes & 1) != ((aDescriptor->DescriptorFlags & IR_DESCRIPTOR_FLAGS_ODD_PARITY) ? 1 : 0)) {
+#if defined(LOCAL_DEBUG)
+            Serial.print(F("Descriptor: "));
+            Serial.println(F("Parity is wrong"));
+#endif
+            return false;
+        }
+        tNumberOfBits--;
+        if (tIsMSBFirst) {
+            tValue >>= 1;
+        } else {
+            tValue &= ~((IRRawDataType) 1 << tNumberOfBits);
+        }
+    }
+
+    /*
+     * Split data in address, command and extra. The address bits are sent first.
+     */
+    uint_fast8_t tNumberOfAddressBits = aDescriptor->NumberOfAddressBits;
+    uint_fast8_t tNumberOfCommandBits = aDescriptor->NumberOfCommandBits;
+    uint_fast8_t tNumberOfExtraBits = tNumberOfBits - tNumberOfAddressBits - tNumberOfCommandBits;
+    if (tIsMSBFirst) {
+        decodedIRData.extra = tValue & ((1UL << tNumberOfExtraBits) - 1);
+        tValue >>= tNumberOfExtraBits;
+        decodedIRData.command = tValue & ((1UL << tNumberOfCommandBits) - 1);
+        decodedIRData.address = tValue >> tNumberOfCommandBits;
+        decodedIRData.flags = IRDATA_FLAGS_IS_MSB_FIRST;
+    } else {
+        decodedIRData.address = tValue & ((1UL << tNumberOfAddressBits) - 1);
+        tValue >>= tNumberOfAddressBits;
+        decodedIRData.command = tValue & ((1UL << tNumberOfCommandBits) - 1);
+        decodedIRData.extra = tValue >> tNumberOfCommandBits;
+    }
+
+    if ((aDescriptor->DescriptorFlags & IR_DESCRIPTOR_FLAGS_EXTRA_IS_INVERTED_COMMAND)
+            && decodedIRData.extra != ((uint16_t) ~decodedIRData.command & ((1UL << tNumberOfExtraBits) - 1))) {
+#if defined(LOCAL_DEBUG)
+        Serial.print(F("Descriptor: "));
+        Serial.println(F("Inverted command is wrong"));
+#endif
+        return false;
+    }
+
+    // Success
+    decodedIRData.protocol = aDescriptor->ProtocolConstants.ProtocolIndex;
+    decodedIRData.decodedRawData = tDecodedData;
+    decodedIRData.numberOfBits = aDescriptor->NumberOfBits;
+#if defined(DECODE_DISTANCE_WIDTH)
+    // enables printIRSendUsage() for descriptors with protocol PULSE_DISTANCE or PULSE_WIDTH
+    decodedIRData.DistanceWidthTimingInfo = aDescriptor->ProtocolConstants.DistanceWidthTimingInfo;
+    decodedIRData.decodedRawDataArray[0] = tDecodedData;
+#endif
+    checkForRepeatSpaceTicksAndSetFlag(getMaximumRepeatSpaceTicks(aDescriptor));
+    return true;
+}
+
+/**
+ * Sends address and command with the descriptor.
+ * If IR_DESCRIPTOR_FLAGS_EXTRA_IS_INVERTED_COMMAND is set, the extra bits are the inverted command, otherwise they are zero.
+ * A parity bit is appended if requested by the descriptor.
+ * @param aDescriptor   Descriptor in RAM e.g. from IrReceiver.loadDescriptor().
+ */
+void IRsend::sendWithDescriptor(IRProtocolDescriptor *aDescriptor, uint16_t aAddress, uint16_t aCommand,
+        int_fast8_t aNumberOfRepeats) {
+    uint_fast8_t tNumberOfParityBits =
+            (aDescriptor->DescriptorFlags & (IR_DESCRIPTOR_FLAGS_EVEN_PARITY | IR_DESCRIPTOR_FLAGS_ODD_PARITY)) ? 1 : 0;
+    uint_fast8_t tNumberOfAddressBits = aDescriptor->NumberOfAddressBits;
+    uint_fast8_t tNumberOfCommandBits = aDescriptor->NumberOfCommandBits;
+    uint_fast8_t tNumberOfExtraBits = aDescriptor->NumberOfBits - tNumberOfParityBits - tNumberOfAddressBits
+            - tNumberOfCommandBits;
+    IRRawDataType tExtra = 0;
+    if (aDescriptor->DescriptorFlags & IR_DESCRIPTOR_FLAGS_EXTRA_IS_INVERTED_COMMAND) {
+        tExtra = (uint16_t) ~aCommand & ((1UL << tNumberOfExtraBits) - 1);
+    }
+    IRRawDataType tCommand = aCommand & ((1UL << tNumberOfCommandBits) - 1);
+    IRRawDataType tAddress = aAddress & ((1UL << tNumberOfAddressBits) - 1);
+
+    bool tIsMSBFirst = (aDescriptor->ProtocolConstants.Flags & PROTOCOL_IS_MSB_FIRST)
+            || (aDescriptor->DescriptorFlags & IR_DESCRIPTOR_FLAGS_BIPHASE);
+    IRRawDataType tRawData;
+    if (tIsMSBFirst) {
+        tRawData = (((tAddress << tNumberOfCommandBits) | tCommand) << tNumberOfExtraBits) | tExtra;
+    } else {
+        tRawData = (((tExtra << tNumberOfCommandBits) | tCommand) << tNumberOfAddressBits) | tAddress;
+    }
+
+    if (tNumberOfParityBits != 0) {
+        uint_fast8_t tParity = (aDescriptor->DescriptorFlags & IR_DESCRIPTOR_FLAGS_ODD_PARITY) ? 1 : 0;
+        for (IRRawDataType tParityValue = tRawData; tParityValue != 0; tParityValue >>= 1) {
+            tParity ^= tParityValue & 1;
+        }
+        if (tIsMSBFirst) {
+            tRawData = (tRawData << 1) | tParity;
+        } else {
+            tRawData |= (IRRawDataType) tParity << (aDescriptor->NumberOfBits - 1);
+        }
+    }
+
+    // Set IR carrier frequency
+    enableIROut(aDescriptor->ProtocolConstants.FrequencyKHz);
+
+    DistanceWidthTimingInfoStruct *tTimingInfo = &aDescriptor->ProtocolConstants.DistanceWidthTimingInfo;
+    uint_fast8_t tNumberOfCommands = aNumberOfRepeats + 1;
+    while (tNumberOfCommands > 0) {
+        unsigned long tStartOfFrameMillis = millis();
+
+        if (tNumberOfCommands < ((uint_fast8_t) aNumberOfRepeats + 1) && aDescriptor->RepeatHeaderSpaceMicros != 0) {
+            // send special repeat
+            mark(tTimingInfo->HeaderMarkMicros);
+            space(aDescriptor->RepeatHeaderSpaceMicros);
+            mark(tTimingInfo->OneMarkMicros);
+        } else if (aDescriptor->DescriptorFlags & IR_DESCRIPTOR_FLAGS_BIPHASE) {
+            sendBiphaseData(tTimingInfo->OneMarkMicros, tRawData, aDescriptor->NumberOfBits);
+        } else {
+            mark(tTimingInfo->HeaderMarkMicros);
+            space(tTimingInfo->HeaderSpaceMicros);
+            sendPulseDistanceWidthData(&aDescriptor->ProtocolConstants, tRawData, aDescriptor->NumberOfBits);
+        }
+
+        tNumberOfCommands--;
+        // skip last delay!
+        if (tNumberOfCommands > 0) {
+            /*
+             * Check and fallback for wrong RepeatPeriodMillis parameter. I.e the repeat period must be greater than each frame duration.
+             */
+            auto tFrameDurationMillis = millis() - tStartOfFrameMillis;
+            if (aDescriptor->ProtocolConstants.RepeatPeriodMillis > tFrameDurationMillis) {
+                delay(aDescriptor->ProtocolConstants.RepeatPeriodMillis - tFrameDurationMillis);
+            }
+        }
+    }
+    IRLedOff();  // Always end with the LED off
+}
+
+/**
+ * Sends address and command with the descriptor.
+ * @param aDescriptorPGM    Descriptor in FLASH (declared with PROGMEM).
+ */
+void IRsend::sendWithDescriptor_P(IRProtocolDescriptor const *aDescriptorPGM, uint16_t aAddress, uint16_t aCommand,
+        int_fast8_t aNumberOfRepeats) {
+    IRProtocolDescriptor tDescriptor;
+    memcpy_P(&tDescriptor, aDescriptorPGM, sizeof(tDescriptor));
+    sendWithDescriptor(&tDescriptor, aAddress, aCommand, aNumberOfRepeats);
+}
+
+/** @}*/
+#if defined(LOCAL_DEBUG)
+#undef LOCAL_DEBUG
+#endif
+#endif // _IR_DESCRIPTOR_HPP
@@ -179,7 +179,7 @@ bool IRrecv::decodeRC5_CDI() {
     /*
      * Get data bits - MSB first
      */
-    for (tBitIndex = 0; sBiphaseDecodeRawbuffOffset < decodedIRData.rawDataPtr->rawlen; tBitIndex++) {
+    for (tBitIndex = 0; biphaseDecodeRawbuffOffset < decodedIRData.rawDataPtr->rawlen; tBitIndex++) {
         // get next 2 levels and check for transition
         uint8_t tStartLevel = getBiphaselevel();
         uint8_t tEndLevel = getBiphaselevel();
@@ -1704,9 +1704,30 @@ bool IRTimerInterruptHandlerHelper(repeating_timer_t*) {
     return true;
 }
 
+#  if defined(ENABLE_IR_CORE1_ENGINE)
+/*
+ * The alarm pool interrupt is enabled on the core, which creates the pool.
+ * Since the default pool is created by core 0, we create our own pool at the first call from core 1.
+ */
+alarm_pool_t *sIRAlarmPool;
+void timerEnableReceiveInterrupt() {
+    if (sIRAlarmPool == NULL) {
+#    if defined(IR_CORE1_HARDWARE_ALARM_NUMBER)
+        if (hardware_alarm_is_claimed(IR_CORE1_HARDWARE_ALARM_NUMBER)) {
+            return; // alarm_pool_create() would panic, setupIREngineOnCore1() reports the error
+        }
+        sIRAlarmPool = alarm_pool_create(IR_CORE1_HARDWARE_ALARM_NUMBER, IR_CORE1_ALARM_POOL_SIZE);
+#    else
+        sIRAlarmPool = alarm_pool_create_with_unused_hardware_alarm(IR_CORE1_ALARM_POOL_SIZE);
+#    endif
+    }
+    alarm_pool_add_repeating_timer_us(sIRAlarmPool, -(MICROS_PER_TICK), IRTimerInterruptHandlerHelper, NULL, &s50usTimer);
+}
+#  else
 void timerEnableReceiveInterrupt() {
     add_repeating_timer_us(-(MICROS_PER_TICK), IRTimerInterruptHandlerHelper, NULL, &s50usTimer);
 }
+#  endif
 void timerDisableReceiveInterrupt() {
     cancel_repeating_timer(&s50usTimer);
 }